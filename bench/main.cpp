@@ -0,0 +1,196 @@
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+
+#include <logger.h>
+
+#if defined(PLATFORM_WINDOWS)
+    #include <io.h>
+    #define BENCH_DUP(fd)           _dup(fd)
+    #define BENCH_DUP2(fd, fd2)     _dup2(fd, fd2)
+    #define BENCH_NULL_DEVICE       "NUL"
+#else
+    #include <unistd.h>
+    #define BENCH_DUP(fd)           ::dup(fd)
+    #define BENCH_DUP2(fd, fd2)     ::dup2(fd, fd2)
+    #define BENCH_NULL_DEVICE       "/dev/null"
+#endif
+
+using namespace logger;
+
+/**
+ * @brief This tool measures cost of log calls.
+ * 
+ * Usage: LoggerBench [messages per thread] [max threads]
+ * 
+ * Each case is printed as one JSON object per line to the standard output, so results of different
+ * releases can be compared by scripts. Console output of the logger is redirected to the null device.
+ * Log files are written to the working directory and removed at the end.
+*/
+
+#define BENCH_DEFAULT_MESSAGES  100000
+#define BENCH_LOG_FILENAME      "bench.log"
+
+struct structBenchResult{
+    std::string output;             // console, file or disabled
+    std::string mode;               // sync or async
+    std::string shape;              // Shape of the message
+    unsigned threads = 0;
+    uint64_t messages = 0;          // Total number of log calls
+    double ns_per_msg = 0;          // Wall time until all messages are written, divided by number of messages
+    double msgs_per_sec = 0;
+    int64_t p50_ns = 0;             // Percentiles of the time spent in a single log call
+    int64_t p99_ns = 0;
+    int64_t p999_ns = 0;
+};
+
+// Logs message i of a thread
+typedef std::function<void(uint64_t)> LogFunction;
+
+static FILE *result_out = stdout;
+
+static int64_t now_ns(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int64_t percentile(const std::vector<int64_t> &sorted, double p){
+    if (sorted.empty()) return 0;
+    std::size_t index = (std::size_t) (p * (double) (sorted.size() - 1));
+    return sorted[index];
+}
+
+static structBenchResult run_case(const std::string &output, const std::string &mode, const std::string &shape,
+                                  unsigned threads, uint64_t messages, const LogFunction &log_one){
+    std::vector<std::vector<int64_t>> latencies(threads, std::vector<int64_t>(messages));
+    std::atomic<unsigned> ready{0};
+    std::atomic<bool> start{false};
+
+    if (mode == "async") Logger::enable_async();
+
+    std::vector<std::thread> workers;
+    for (unsigned t=0; t<threads; t++){
+        workers.emplace_back([&, t](){
+            std::vector<int64_t> &latency = latencies[t];
+            ready.fetch_add(1);
+            while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t i=0; i<messages; i++){
+                int64_t begin = now_ns();
+                log_one(i);
+                latency[i] = now_ns() - begin;
+            }
+        });
+    }
+    while (ready.load() < threads) std::this_thread::yield();
+
+    int64_t begin = now_ns();
+    start.store(true, std::memory_order_release);
+    for (auto &worker: workers) worker.join();
+    if (mode == "async") Logger::disable_async();
+    Logger::flush();
+    int64_t elapsed = now_ns() - begin;
+
+    std::vector<int64_t> all;
+    all.reserve(threads * messages);
+    for (const auto &latency: latencies) all.insert(all.end(), latency.begin(), latency.end());
+    std::sort(all.begin(), all.end());
+
+    structBenchResult result;
+    result.output = output;
+    result.mode = mode;
+    result.shape = shape;
+    result.threads = threads;
+    result.messages = threads * messages;
+    result.ns_per_msg = (double) elapsed / (double) result.messages;
+    result.msgs_per_sec = 1e9 / result.ns_per_msg;
+    result.p50_ns = percentile(all, 0.50);
+    result.p99_ns = percentile(all, 0.99);
+    result.p999_ns = percentile(all, 0.999);
+    return result;
+}
+
+static void print_result(const structBenchResult &r){
+    std::fprintf(result_out,
+                 "{\"output\":\"%s\",\"mode\":\"%s\",\"shape\":\"%s\",\"threads\":%u,\"messages\":%llu,"
+                 "\"ns_per_msg\":%.1f,\"msgs_per_sec\":%.0f,\"p50_ns\":%lld,\"p99_ns\":%lld,\"p999_ns\":%lld}\n",
+                 r.output.c_str(), r.mode.c_str(), r.shape.c_str(), r.threads, (unsigned long long) r.messages,
+                 r.ns_per_msg, r.msgs_per_sec, (long long) r.p50_ns, (long long) r.p99_ns, (long long) r.p999_ns);
+    std::fflush(result_out);
+}
+
+// Selects the outputs of the logger. Disabled output writes to the file, but the threshold discards the DEBUG messages of the case.
+static void select_output(const std::string &output, const std::shared_ptr<FileSink> &file_sink){
+    Logger::remove_sink(Logger::get_console_sink());
+    Logger::remove_sink(file_sink);
+    if (output == "console") Logger::add_sink(Logger::get_console_sink());
+    else Logger::add_sink(file_sink);
+    Logger::set_log_threshold(output == "disabled"? enumLogLevel::INFO_: enumLogLevel::TRACE_);
+}
+
+int main(int argc, char *argv[]){
+    uint64_t messages = (argc > 1)? std::strtoull(argv[1], nullptr, 10): BENCH_DEFAULT_MESSAGES;
+    unsigned max_threads = (argc > 2)? (unsigned) std::strtoul(argv[2], nullptr, 10): std::max<unsigned>(4u, std::thread::hardware_concurrency());
+    if (messages == 0 || max_threads == 0){
+        std::fprintf(stderr, "Usage: %s [messages per thread] [max threads]\n", argv[0]);
+        return 1;
+    }
+
+    // Results keep the original standard output, console output of the logger goes to the null device
+    std::fflush(stdout);
+    result_out = fdopen(BENCH_DUP(1), "w");
+    if (result_out == nullptr || std::freopen(BENCH_NULL_DEVICE, "w", stdout) == nullptr){
+        std::fprintf(stderr, "Standard output cannot be redirected.\n");
+        return 1;
+    }
+
+    auto file_sink = std::make_shared<FileSink>();
+    if (!file_sink->open(BENCH_LOG_FILENAME, ".")) return 1;
+
+    const std::string long_text(200, 'x');
+    const std::vector<std::pair<std::string, LogFunction>> shapes = {
+        {"short_literal", [](uint64_t){ LogInfo << "Connection established"; }},
+        {"long_string", [&](uint64_t){ LogInfo << long_text; }},
+        {"multiple_fields", [](uint64_t i){ LogInfo << "request id=" << i << " latency=" << 0.25 * (double) i << " user=" << "admin" << " ok=" << true; }},
+        {"source_enabled", [](uint64_t){ LogDebug << "Connection established"; }},
+        {"colors_enabled", [](uint64_t){ LogInfo << "Connection established"; }},
+    };
+
+    // Cost of message shapes on a single thread
+    for (const std::string output: {"console", "file"}){
+        select_output(output, file_sink);
+        for (const auto &shape: shapes){
+            if (shape.first == "colors_enabled" && output != "console") continue;
+            if (shape.first == "source_enabled") Logger::enable_source();
+            if (shape.first == "colors_enabled") Logger::enable_colors();
+            print_result(run_case(output, "sync", shape.first, 1, messages, shape.second));
+            Logger::disable_source();
+            Logger::disable_colors();
+        }
+    }
+
+    const LogFunction disabled_log = [](uint64_t){ LogDebug << "Connection established"; };
+
+    // Scaling of throughput with producer threads
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads=1; threads<max_threads; threads*=2) thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    for (const std::string output: {"console", "file", "disabled"}){
+        select_output(output, file_sink);
+        for (const std::string mode: {"sync", "async"}){
+            for (unsigned threads: thread_counts){
+                print_result(run_case(output, mode, "short_literal", threads, messages, (output == "disabled")? disabled_log: shapes[0].second));
+            }
+        }
+    }
+
+    Logger::remove_sink(file_sink);
+    file_sink.reset();
+    std::remove(BENCH_LOG_FILENAME);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+
+#include <logger_decode.h>
+
+using namespace logger;
+
+/**
+ * @brief This tool converts binary log files written by LogXxxBin macros to text.
+ * 
+ * Usage: logger-decode <binary log file> [output file]
+ * 
+ * If output file is not provided, decoded lines are written to the console.
+*/
+
+int main(int argc, char *argv[]){
+    if (argc < 2){
+        std::cerr << "Usage: " << argv[0] << " <binary log file> [output file]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input.is_open()){
+        std::cerr << "Binary log file cannot be opened: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    std::size_t pos = 0;
+    if (!decode_binary_header(data, pos)){
+        std::cerr << "File is not a binary log file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::string out;
+    bool is_valid = decode_binary_entries(data, pos, out);
+
+    if (argc > 2){
+        std::ofstream output(argv[2], std::ios::out | std::ios::binary);
+        output << out;
+    }
+    else{
+        std::cout << out;
+    }
+
+    if (!is_valid){
+        std::cerr << "Binary log file is truncated or corrupted at offset " << pos << "." << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -8,20 +8,174 @@
 #include <mutex>
 #include <cstdint>
 #include <fstream>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <tuple>
+#include <condition_variable>
 
 #include <logger_utils.h>
+#include <logger_queue.h>
+#include <logger_file.h>
+#include <logger_binary.h>
+#include <logger_category.h>
+#include <logger_record.h>
+#include <logger_limit.h>
+#include <logger_stats.h>
+#include <logger_config.h>
+#include <logger_sink.h>
 
 namespace logger{
 
+    // Numeric values of log levels to be used with LOGGER_ACTIVE_LEVEL
+    #define LOGGER_LEVEL_FATAL      0
+    #define LOGGER_LEVEL_ERROR      1
+    #define LOGGER_LEVEL_ALERT      2
+    #define LOGGER_LEVEL_WARNING    3
+    #define LOGGER_LEVEL_INFO       4
+    #define LOGGER_LEVEL_DEBUG      5
+    #define LOGGER_LEVEL_TRACE      6
+
+    // Log macros of levels above the active level compile to nothing, and their operands are not evaluated.
+    // It can be overridden by the compiler flag (e.g. -DLOGGER_ACTIVE_LEVEL=LOGGER_LEVEL_INFO).
+    #ifndef LOGGER_ACTIVE_LEVEL
+        #define LOGGER_ACTIVE_LEVEL LOGGER_LEVEL_TRACE
+    #endif
+
+    // This macro returns the source location of the call site. Its "basename:line" text is rendered at compile time into a static constant.
+    #define LOGGER_SOURCE_LOCATION_() \
+        ([]() -> const structSourceLocation * { \
+            static constexpr structSourceText<sizeof(__FILE__)> logger_source_text_(__FILE__, __LINE__); \
+            static constexpr structSourceLocation logger_source_location_{__FILE__, __LINE__, logger_source_text_.data, logger_source_text_.size}; \
+            return &logger_source_location_; \
+        }())
+
+    // This macro reads the runtime settings once, if the level passes the compile-time threshold. They are null otherwise.
+    #define LOGGER_SETTINGS_IF_ACTIVE_(level) \
+        (((int) (level) <= LOGGER_ACTIVE_LEVEL)? Logger::get_settings(): nullptr)
+
+    // This macro checks the compile-time and runtime thresholds before anything else of the log call is evaluated
+    #define LOGGER_LOG_IF_ENABLED_(level) \
+        if (const structLogSettings *logger_settings_ = LOGGER_SETTINGS_IF_ACTIVE_(level); \
+            logger_settings_ == nullptr || !logger_settings_->is_level_enabled(level)) {} \
+        else LogRecord(level, LOGGER_SOURCE_LOCATION_(), logger_settings_)
+
     // These macros are log functions for users. It eases to use of the class for different level log operations
-    #define LogFatal        *(Logger::getInstance()->set_log_level(enumLogLevel::FATAL_,     __FILE__, __LINE__))
-    #define LogError        *(Logger::getInstance()->set_log_level(enumLogLevel::ERROR_,     __FILE__, __LINE__))
-    #define LogAlert        *(Logger::getInstance()->set_log_level(enumLogLevel::ALERT_,     __FILE__, __LINE__))
-    #define LogWarning      *(Logger::getInstance()->set_log_level(enumLogLevel::WARNING_,   __FILE__, __LINE__))
-    #define LogInfo         *(Logger::getInstance()->set_log_level(enumLogLevel::INFO_,      __FILE__, __LINE__))
-    #define LogDebug        *(Logger::getInstance()->set_log_level(enumLogLevel::DEBUG_,     __FILE__, __LINE__))
-    #define LogTrace        *(Logger::getInstance()->set_log_level(enumLogLevel::TRACE_,     __FILE__, __LINE__))
+    #define LogFatal        LOGGER_LOG_IF_ENABLED_(enumLogLevel::FATAL_)
+    #define LogError        LOGGER_LOG_IF_ENABLED_(enumLogLevel::ERROR_)
+    #define LogAlert        LOGGER_LOG_IF_ENABLED_(enumLogLevel::ALERT_)
+    #define LogWarning      LOGGER_LOG_IF_ENABLED_(enumLogLevel::WARNING_)
+    #define LogInfo         LOGGER_LOG_IF_ENABLED_(enumLogLevel::INFO_)
+    #define LogDebug        LOGGER_LOG_IF_ENABLED_(enumLogLevel::DEBUG_)
+    #define LogTrace        LOGGER_LOG_IF_ENABLED_(enumLogLevel::TRACE_)
+
+    // This macro checks the level of the category instead of the runtime threshold, and writes the category name with the message
+    #define LOGGER_LOG_CATEGORY_IF_ENABLED_(category, level) \
+        if (const structLogSettings *logger_settings_ = LOGGER_SETTINGS_IF_ACTIVE_(level); \
+            logger_settings_ == nullptr || !(category).is_level_enabled(level)) {} \
+        else LogRecord(level, LOGGER_SOURCE_LOCATION_(), (category), logger_settings_)
+
+    // These macros log to a category returned by Logger::get (e.g. LogDebugIn(tcp_log) << "Connected")
+    #define LogFatalIn(category)    LOGGER_LOG_CATEGORY_IF_ENABLED_(category, enumLogLevel::FATAL_)
+    #define LogErrorIn(category)    LOGGER_LOG_CATEGORY_IF_ENABLED_(category, enumLogLevel::ERROR_)
+    #define LogAlertIn(category)    LOGGER_LOG_CATEGORY_IF_ENABLED_(category, enumLogLevel::ALERT_)
+    #define LogWarningIn(category)  LOGGER_LOG_CATEGORY_IF_ENABLED_(category, enumLogLevel::WARNING_)
+    #define LogInfoIn(category)     LOGGER_LOG_CATEGORY_IF_ENABLED_(category, enumLogLevel::INFO_)
+    #define LogDebugIn(category)    LOGGER_LOG_CATEGORY_IF_ENABLED_(category, enumLogLevel::DEBUG_)
+    #define LogTraceIn(category)    LOGGER_LOG_CATEGORY_IF_ENABLED_(category, enumLogLevel::TRACE_)
+
+    // This macro keeps the limiter of the call site in a function-local static, and skips the record when the limiter suppresses the call.
+    // Suppressed calls are counted and reported at the end of the next emitted message of the call site.
+    #define LOGGER_LOG_LIMITED_(level, limiter_type, arg) \
+        if (const structLogSettings *logger_settings_ = LOGGER_SETTINGS_IF_ACTIVE_(level); \
+            logger_settings_ == nullptr || !logger_settings_->is_level_enabled(level)) {} \
+        else if (auto &logger_limiter_ = []() -> limiter_type & { static limiter_type limiter; return limiter; }(); !logger_limiter_.should_log(arg)) {} \
+        else LogRecord(level, LOGGER_SOURCE_LOCATION_(), logger_settings_).set_suppressed_count(logger_limiter_.take_suppressed())
+
+    // These macros log one of every n calls of the call site (e.g. LogWarningEvery(100) << "Retrying")
+    #define LogFatalEvery(n)    LOGGER_LOG_LIMITED_(enumLogLevel::FATAL_,   EveryNLimiter, n)
+    #define LogErrorEvery(n)    LOGGER_LOG_LIMITED_(enumLogLevel::ERROR_,   EveryNLimiter, n)
+    #define LogAlertEvery(n)    LOGGER_LOG_LIMITED_(enumLogLevel::ALERT_,   EveryNLimiter, n)
+    #define LogWarningEvery(n)  LOGGER_LOG_LIMITED_(enumLogLevel::WARNING_, EveryNLimiter, n)
+    #define LogInfoEvery(n)     LOGGER_LOG_LIMITED_(enumLogLevel::INFO_,    EveryNLimiter, n)
+    #define LogDebugEvery(n)    LOGGER_LOG_LIMITED_(enumLogLevel::DEBUG_,   EveryNLimiter, n)
+    #define LogTraceEvery(n)    LOGGER_LOG_LIMITED_(enumLogLevel::TRACE_,   EveryNLimiter, n)
+
+    // These macros log at most the given number of calls of the call site per second (e.g. LogWarningRateLimited(10) << "Queue full")
+    #define LogFatalRateLimited(per_second)     LOGGER_LOG_LIMITED_(enumLogLevel::FATAL_,   RateLimiter, per_second)
+    #define LogErrorRateLimited(per_second)     LOGGER_LOG_LIMITED_(enumLogLevel::ERROR_,   RateLimiter, per_second)
+    #define LogAlertRateLimited(per_second)     LOGGER_LOG_LIMITED_(enumLogLevel::ALERT_,   RateLimiter, per_second)
+    #define LogWarningRateLimited(per_second)   LOGGER_LOG_LIMITED_(enumLogLevel::WARNING_, RateLimiter, per_second)
+    #define LogInfoRateLimited(per_second)      LOGGER_LOG_LIMITED_(enumLogLevel::INFO_,    RateLimiter, per_second)
+    #define LogDebugRateLimited(per_second)     LOGGER_LOG_LIMITED_(enumLogLevel::DEBUG_,   RateLimiter, per_second)
+    #define LogTraceRateLimited(per_second)     LOGGER_LOG_LIMITED_(enumLogLevel::TRACE_,   RateLimiter, per_second)
+
+    // These macros log each call of the call site with probability p in range [0, 1] (e.g. LogDebugSampled(0.01) << "Packet received")
+    #define LogFatalSampled(p)      LOGGER_LOG_LIMITED_(enumLogLevel::FATAL_,   SampleLimiter, p)
+    #define LogErrorSampled(p)      LOGGER_LOG_LIMITED_(enumLogLevel::ERROR_,   SampleLimiter, p)
+    #define LogAlertSampled(p)      LOGGER_LOG_LIMITED_(enumLogLevel::ALERT_,   SampleLimiter, p)
+    #define LogWarningSampled(p)    LOGGER_LOG_LIMITED_(enumLogLevel::WARNING_, SampleLimiter, p)
+    #define LogInfoSampled(p)       LOGGER_LOG_LIMITED_(enumLogLevel::INFO_,    SampleLimiter, p)
+    #define LogDebugSampled(p)      LOGGER_LOG_LIMITED_(enumLogLevel::DEBUG_,   SampleLimiter, p)
+    #define LogTraceSampled(p)      LOGGER_LOG_LIMITED_(enumLogLevel::TRACE_,   SampleLimiter, p)
+
+    // Helper macros to split the format string from the arguments of formatted log macros
+    #define LOGGER_EXPAND_(x) x
+    #define LOGGER_FIRST_ARG_IMPL_(first, ...) first
+    #define LOGGER_FIRST_ARG_(...) LOGGER_EXPAND_(LOGGER_FIRST_ARG_IMPL_(__VA_ARGS__, 0))
+
+    // This macro fails the build if the number of "{}" placeholders of the format string does not match the number of arguments
+    #define LOGGER_CHECK_FORMAT_(...) \
+        static_assert(count_placeholders(LOGGER_FIRST_ARG_(__VA_ARGS__)) >= 0, "Format string has an unmatched brace."); \
+        static_assert(count_placeholders(LOGGER_FIRST_ARG_(__VA_ARGS__)) == (int) std::tuple_size<decltype(std::forward_as_tuple(__VA_ARGS__))>::value - 1, \
+                      "Number of arguments does not match the number of {} placeholders.")
+
+    // This macro formats arguments directly into a log record
+    #define LOGGER_LOG_FORMAT_(level, ...) \
+        do { \
+            LOGGER_CHECK_FORMAT_(__VA_ARGS__); \
+            if (const structLogSettings *logger_settings_ = LOGGER_SETTINGS_IF_ACTIVE_(level); \
+                logger_settings_ != nullptr && logger_settings_->is_level_enabled(level)){ \
+                LogRecord(level, LOGGER_SOURCE_LOCATION_(), logger_settings_).format(__VA_ARGS__); \
+            } \
+        } while (0)
+
+    // These macros are log functions with format string checked at compile time (e.g. LogInfoF("x={} y={}", x, y))
+    #define LogFatalF(...)      LOGGER_LOG_FORMAT_(enumLogLevel::FATAL_,    __VA_ARGS__)
+    #define LogErrorF(...)      LOGGER_LOG_FORMAT_(enumLogLevel::ERROR_,    __VA_ARGS__)
+    #define LogAlertF(...)      LOGGER_LOG_FORMAT_(enumLogLevel::ALERT_,    __VA_ARGS__)
+    #define LogWarningF(...)    LOGGER_LOG_FORMAT_(enumLogLevel::WARNING_,  __VA_ARGS__)
+    #define LogInfoF(...)       LOGGER_LOG_FORMAT_(enumLogLevel::INFO_,     __VA_ARGS__)
+    #define LogDebugF(...)      LOGGER_LOG_FORMAT_(enumLogLevel::DEBUG_,    __VA_ARGS__)
+    #define LogTraceF(...)      LOGGER_LOG_FORMAT_(enumLogLevel::TRACE_,    __VA_ARGS__)
+
+    // This macro registers the call site once and logs "{}" formatted arguments.
+    // If binary output is set, arguments are stored raw and formatted later by the decoder.
+    #define LOGGER_LOG_BINARY_(level, ...) \
+        do { \
+            LOGGER_CHECK_FORMAT_(__VA_ARGS__); \
+            if (const structLogSettings *logger_settings_ = LOGGER_SETTINGS_IF_ACTIVE_(level); \
+                logger_settings_ != nullptr && logger_settings_->is_level_enabled(level)){ \
+                static const structCallSite logger_call_site_{level, __FILE__, __LINE__, LOGGER_FIRST_ARG_(__VA_ARGS__), LOGGER_SOURCE_LOCATION_()}; \
+                static const uint32_t logger_call_site_id_ = Logger::register_call_site(logger_call_site_); \
+                Logger::log_binary(logger_call_site_, logger_call_site_id_, logger_settings_, __VA_ARGS__); \
+            } \
+        } while (0)
+
+    // These macros are log functions with format string (e.g. LogInfoBin("x={} y={}", x, y)) that support binary output
+    #define LogFatalBin(...)    LOGGER_LOG_BINARY_(enumLogLevel::FATAL_,    __VA_ARGS__)
+    #define LogErrorBin(...)    LOGGER_LOG_BINARY_(enumLogLevel::ERROR_,    __VA_ARGS__)
+    #define LogAlertBin(...)    LOGGER_LOG_BINARY_(enumLogLevel::ALERT_,    __VA_ARGS__)
+    #define LogWarningBin(...)  LOGGER_LOG_BINARY_(enumLogLevel::WARNING_,  __VA_ARGS__)
+    #define LogInfoBin(...)     LOGGER_LOG_BINARY_(enumLogLevel::INFO_,     __VA_ARGS__)
+    #define LogDebugBin(...)    LOGGER_LOG_BINARY_(enumLogLevel::DEBUG_,    __VA_ARGS__)
+    #define LogTraceBin(...)    LOGGER_LOG_BINARY_(enumLogLevel::TRACE_,    __VA_ARGS__)
+
     #define HomeDir         get_home_dir()
+
+    // Asynchronous buffer of a producer thread. It is defined in logger.cpp.
+    struct structThreadBuffer;
     
     /**
      * @class Logger
@@ -29,67 +183,418 @@ namespace logger{
      * @brief This class can log the messages into console or files with predefined format.
      * 
      * This class uses Singleton pattern so one instance can be used throught out the application for log operations.
-     * Thread safety mechanism exists, and to enable it by calling set_thread_safety(true).
+     * Log level and source of a message are kept per thread, and outputs are serialized internally, so log calls
+     * can be made from any thread. Creation of the instance is guarded when set_thread_safety(true) is called.
      * 
     */
     class Logger{
     private:
         static Logger *ptr_instance_;
         static std::mutex mutex_;
-        static structLogFormat fmt_;
 
         static std::string config_file_path_;
-        static std::string out_file_dir_;
-        static std::string out_filename_;
-        static std::string root_filename_;
-        
-        static enumLogLevel current_level_;
+
+        static LogFile binary_file_;
+        static std::mutex binary_mutex_;
+        static std::atomic<bool> is_binary_enabled_;
+        static std::atomic<uint64_t> binary_bytes_written_;
+        static std::atomic<uint32_t> call_site_counter_;
+        static std::vector<bool> binary_sites_written_;
 
         static bool is_output_set_;
         static bool is_configure_set_;
         static bool is_thread_safe_;
-        static bool color_enabled_;
-        static bool is_source_enabled_;
 
-        static uint64_t err_counter_;
+        static std::atomic<uint64_t> err_counter_;
 
         static std::stringstream sstream_;
-        static std::ofstream log_file_;
 
-        static std::string log_source_file_;
-        static int log_source_line_;
+        static thread_local structLogContext context_;
 
-        static std::map<enumLogLevel, structLogLevel> mapLogLevel;
-        
-        static bool timestamp_suffix_enabled_;
-        static structTimestamp currentTimestamp_;
+        static const structLogLevel level_table_[LOG_LEVEL_COUNT];
+
+        static std::vector<std::unique_ptr<LineFormatter>> formatters_;
+        static std::mutex formatters_mutex_;
+
+        static std::vector<std::unique_ptr<const structLogSettings>> settings_list_;
+        static std::mutex settings_mutex_;
+        static std::atomic<const structLogSettings*> settings_;
+
+        static std::shared_ptr<ConsoleSink> console_sink_;
+        static std::shared_ptr<FileSink> file_sink_;
+        static std::mutex sinks_mutex_;
+        static std::shared_ptr<const std::vector<std::shared_ptr<LogSink>>> sinks_;
+        static std::atomic<uint64_t> sinks_version_;
+        static std::atomic<const std::vector<std::shared_ptr<LogSink>>*> current_sinks_;
+
+        static std::vector<std::shared_ptr<structThreadBuffer>> thread_buffers_;
+        static std::mutex thread_buffers_mutex_;
+        static std::atomic<uint64_t> thread_buffers_version_;
+        static std::atomic<std::size_t> async_capacity_;
+        static std::thread async_writer_;
+        static std::atomic<bool> is_async_enabled_;
+        static std::atomic<bool> async_stop_requested_;
+        static enumOverflowPolicy async_overflow_policy_;
+        static std::atomic<uint64_t> async_dropped_counter_;
+
+        static std::atomic<int64_t> async_drain_deadline_ns_;
+        static std::atomic<bool> crash_flush_requested_;
+        static std::atomic<bool> crash_flush_done_;
+        static std::atomic<bool> is_crash_handler_enabled_;
+
+        static std::atomic<bool> is_duplicate_suppression_enabled_;
+        static std::atomic<uint32_t> duplicate_interval_ms_;
+
+        static std::vector<std::unique_ptr<const structLogConfig>> configs_;
+        static std::mutex config_mutex_;
+        static std::atomic<const structLogConfig*> config_;
+        static std::thread config_watcher_;
+        static std::mutex config_watch_mutex_;
+        static std::condition_variable config_watch_cv_;
+        static std::atomic<bool> config_watch_stop_requested_;
+        static int config_watch_fd_;
+        static int config_watch_wd_;
+
+        static std::thread housekeeping_thread_;
+        static std::mutex housekeeping_mutex_;
+        static std::condition_variable housekeeping_cv_;
+        static structPruneRequest prune_request_;
+        static bool is_prune_requested_;
+        static bool housekeeping_stop_requested_;
+        static bool is_console_flush_requested_;
+        static bool is_housekeeping_wake_requested_;
+
+        /**
+         * @brief This private function applies the settings of a configuration snapshot.
+         * 
+         * @param[in] config Settings to be applied
+         * @param[in] previous Settings applied before. Nullptr if it is the first configuration.
+         * 
+        */
+        static void apply_config_(const structLogConfig &config, const structLogConfig *previous);
 
         /**
-         * @brief This private function creates log string that is ready to either write console or file.
+         * @brief This private function starts the thread that reloads the configuration file when it is changed.
          * 
-         * According to content of msg_log content, it adds message fields (Timetamp, Log Level, Log Content etc.) to the output string.
+         * Changes are notified by inotify on Linux, and the modification time is polled on other platforms.
          * 
-         * @param[in] msg_log Log message structure to be logged
+        */
+        static void start_config_watch_();
+
+        /**
+         * @brief This private function stops the thread that watches the configuration file.
          * 
-         * @return Output log message string
         */
-        static std::string log_out_(const structLogMsg &msg_log);
-        
+        static void stop_config_watch_();
+
+        /**
+         * @brief This private function waits for changes of the configuration file and reloads it.
+         * 
+        */
+        static void config_watch_loop_();
+
+        /**
+         * @brief This private function compiles the log format into pre-rendered parts of log lines.
+         * 
+         * @param[in] fmt Log format
+         * 
+         * @return Compiled layout
+        */
+        static structLineLayout compile_layout_(const structLogFormat &fmt);
+
+        /**
+         * @brief This private function returns the formatter of the log format. It is created once per distinct format.
+         * 
+         * @param[in] fmt Log format
+         * 
+         * @return Formatter that lives until the application exits
+        */
+        static const LineFormatter *intern_formatter_(const structLogFormat &fmt);
+
         /**
-         * @brief This private function writes log message structure to system's console.
+         * @brief This private function returns the snapshot of the settings. It is created once per distinct settings.
+         * 
+         * Snapshots are immutable and live until the application exits, so log calls read them without locking.
+         * Settings mutex must be held by the caller, except on static initialization.
+         * 
+         * @param[in] settings Settings of the snapshot
+         * 
+         * @return Snapshot of the settings
+        */
+        static const structLogSettings *intern_settings_(const structLogSettings &settings);
+
+        /**
+         * @brief This private function publishes the settings to log calls. Settings mutex must be held by the caller.
+         * 
+         * @param[in] settings Settings to be published
+         * 
+        */
+        static void publish_settings_(const structLogSettings &settings);
+
+        /**
+         * @brief This private function publishes a list of sinks to be read by logging threads. Sinks mutex must be held by the caller.
+         * 
+         * Lists are immutable and shared. A replaced list is released once every thread has moved to a newer one.
+         * 
+         * @param[in] sinks Sinks of the list
+         * 
+        */
+        static void publish_sinks_(std::vector<std::shared_ptr<LogSink>> sinks);
+
+        /**
+         * @brief This private function returns the list of sinks.
+         * 
+         * The list is kept per thread and loaded again only after a sink is added or removed, so reading it takes a single atomic load.
+         * 
+         * @return List of sinks. It is valid until the next call on the same thread.
+        */
+        static const std::vector<std::shared_ptr<LogSink>> &get_sinks_();
+
+        /**
+         * @brief This private function returns the index of log level in level tables.
+         * 
+         * @param[in] log_level Enumeration of log level
+         * 
+         * @return Index of log level. Unknown levels are mapped to INVALID_.
+        */
+        static inline std::size_t level_index_(enumLogLevel log_level) noexcept{
+            std::size_t idx = (std::size_t) log_level;
+            return (idx < LOG_LEVEL_COUNT)? idx: (std::size_t) enumLogLevel::INVALID_;
+        }
+
+        /**
+         * @brief This private function writes log message to the sinks whose level accepts it.
+         * 
+         * Message is formatted once per distinct format of the sinks.
          * 
          * @param[in] msg_log Message structure to be logged
          * 
         */
-        static void write_console_(const structLogMsg &msg_log);
-        
+        static void write_outputs_(const structLogMsg &msg_log);
+
+        /**
+         * @brief This private function commits pending batches of all sinks.
+         * 
+         * @param[in] force If false, only batches past the latency bound and time-based flushes that are due are written.
+         * 
+        */
+        static void commit_sinks_(bool force);
+
+        /**
+         * @brief This private function asks the housekeeping thread to delete rotated files beyond the limit.
+         * 
+         * @param[in] request Log files to be checked
+         * 
+        */
+        static void request_prune_(const structPruneRequest &request);
+
         /**
-         * @brief This private function writes log message structure to defined log file.
+         * @brief This private function starts the housekeeping thread if it is not running.
+         * 
+         * Housekeeping mutex must be held by the caller.
+         * 
+        */
+        static void start_housekeeping_();
+
+        /**
+         * @brief This private function makes the housekeeping thread write pending lines of the block-buffered console periodically.
+         * 
+        */
+        static void start_console_flush_();
+
+        /**
+         * @brief This private function updates cached levels of all categories after a level is changed.
+         * 
+         * Category registry mutex must be held by the caller.
+         * 
+        */
+        static void resolve_category_levels_() noexcept;
+
+        /**
+         * @brief This private function is the main loop of the housekeeping thread.
+         * 
+        */
+        static void housekeeping_loop_();
+
+        /**
+         * @brief This private function stops the housekeeping thread after its pending work is done.
+         * 
+        */
+        static void stop_housekeeping_();
+
+        /**
+         * @brief This private function registers shutdown to be called at normal exit. It is registered only once.
+         * 
+        */
+        static void register_exit_handler_();
+
+        /**
+         * @brief This private function writes a record to the binary log file.
+         * 
+         * Metadata of the call site is written before its first record in the file.
+         * 
+         * @param[in] site Call site of the record
+         * @param[in] site_id Id of the call site
+         * @param[in] settings Settings read by the log call
+         * @param[in] payload Tagged arguments of the record
+         * 
+        */
+        static void write_binary_record_(const structCallSite &site, uint32_t site_id, const structLogSettings &settings, const std::string &payload);
+
+        /**
+         * @brief This private function formats a record of a binary call site as text and routes it to the outputs.
+         * 
+         * It is used when binary output is not set.
+         * 
+         * @param[in] site Call site of the record
+         * @param[in] settings Settings read by the log call
+         * @param[in] payload Tagged arguments of the record
+         * 
+        */
+        static void log_formatted_(const structCallSite &site, const structLogSettings &settings, const std::string &payload);
+
+        /**
+         * @brief This private function starts a log record with the log context of the calling thread.
+         * 
+         * @return Log record. It is inactive if the log level does not pass the runtime threshold.
+         * 
+        */
+        static LogRecord start_record_() noexcept;
+
+        /**
+         * @brief This private function returns the source field of a message.
+         * 
+         * @param[in] settings Settings read by the log call
+         * @param[in] level Log level of the message
+         * @param[in] location Call site of the message
+         * 
+         * @return Call site if source info is shown for the level, nullptr otherwise
+         * 
+        */
+        static const structSourceLocation *make_source_(const structLogSettings &settings, enumLogLevel level, const structSourceLocation *location) noexcept;
+
+        /**
+         * @brief This private function returns the source location of a call site that is known only at runtime.
+         * 
+         * Locations are created once per file and line and live until the application exits.
+         * 
+         * @param[in] file File where the log function is called
+         * @param[in] line Line where the log function is called
+         * 
+         * @return Source location
+         * 
+        */
+        static const structSourceLocation *intern_source_location_(const char *file, int line);
+
+        /**
+         * @brief This private function checks whether the record repeats the last message of its call site.
+         * 
+         * The message is compared by its hash before the timestamp is taken or the line is formatted.
+         * Repeats are counted, and "Last message repeated N times" is emitted when the message changes
+         * or the interval has passed since the first counted repeat.
+         * 
+         * @param[in] record Completed log record
+         * 
+         * @return True if the record is a repeat and must not be emitted
+         * 
+        */
+        static bool suppress_duplicate_(const LogRecord &record);
+
+        /**
+         * @brief This private function emits "Last message repeated N times" for a call site.
+         * 
+         * @param[in] level Log level of the repeated message
+         * @param[in] location Call site
+         * @param[in] count Number of repeats
+         * 
+        */
+        static void emit_repeat_summary_(enumLogLevel level, const structSourceLocation *location, uint64_t count);
+
+        /**
+         * @brief This private function emits the summaries of call sites that have counted repeats.
+         * 
+         * @param[in] force If false, only summaries whose interval has passed since the first repeat are emitted.
+         * 
+        */
+        static void flush_repeat_summaries_(bool force);
+
+        /**
+         * @brief This private function converts completed log record to log message structure and routes it to the outputs.
+         * 
+         * It is called by the destructor of LogRecord.
+         * 
+         * @param[in] record Completed log record
+         * 
+        */
+        static void submit_record_(LogRecord &record);
+
+        /**
+         * @brief This private function routes completed log message to the outputs.
+         * 
+         * In asynchronous mode, the message is only pushed into the queue and written later by the writer thread.
+         * Otherwise, it is written to the console and the log file on the calling thread.
          * 
          * @param[in] msg_log Message structure to be logged
          * 
         */
-        static void write_file_(const structLogMsg &msg_log);
+        static void dispatch_(const structLogMsg &msg_log);
+
+        /**
+         * @brief This private function returns the asynchronous buffer of the calling thread.
+         * 
+         * The buffer is created and registered on the first call of the thread. It is marked as retired when the thread exits.
+         * 
+         * @return Buffer of the thread, or nullptr if the thread is exiting and its buffer is already released
+         * 
+        */
+        static structThreadBuffer *get_thread_buffer_();
+
+        /**
+         * @brief This private function pops all pending messages from the buffers of producer threads and writes them to the outputs.
+         * 
+         * Heads of the buffers are merged, so messages of different threads are written in timestamp order.
+         * Buffers of exited threads are released once they are drained.
+         * It must only be called from a single thread at a time.
+         * 
+         * @return Number of written messages
+         * 
+        */
+        static std::size_t drain_async_queue_(int64_t deadline_ns=INT64_MAX);
+
+        /**
+         * @brief This private function is the main loop of the asynchronous writer thread.
+         * 
+        */
+        static void async_writer_loop_();
+
+        /**
+         * @brief This private function stops the writer thread and writes the remaining messages.
+         * 
+         * @param[in] deadline_ns Steady clock time in nanoseconds after which remaining messages are left unwritten
+         * 
+         * @return True if all messages are written before the deadline
+         * 
+        */
+        static bool stop_async_(int64_t deadline_ns);
+
+        /**
+         * @brief This private function waits until the writer thread has written the messages of the calling thread, then flushes all sinks.
+         * 
+         * It is called after FATAL messages, so they reach the outputs before the application terminates.
+         * 
+        */
+        static void drain_for_fatal_();
+
+        /**
+         * @brief This private function is the handler of fatal signals.
+         * 
+         * It asks the writer thread to write pending messages, writes buffered content of the sinks with
+         * async-signal-safe calls, then restores the previous handler and raises the signal again.
+         * 
+         * @param[in] sig Signal number
+         * 
+        */
+        static void crash_handler_(int sig);
 
         /**
          * @brief This private function handles internal log errors and prints to the console.
@@ -107,17 +612,9 @@ namespace logger{
          * @return Escape characters of color code 
          * 
         */
-        static inline std::string pick_log_color_(enumLogLevel log_level);
-        
-        /**
-         * @brief This private function sets timestamp prefix to the filename.
-         * 
-         * @param[in] ts Timestamp struct
-         * 
-         * @return Prefixed filename 
-         * 
-        */
-        static inline std::string add_timestamp_prefix_(structTimestamp ts);
+        static inline const std::string &pick_log_color_(enumLogLevel log_level){
+            return level_table_[level_index_(log_level)].color;
+        }
 
         /**
          * @brief This private function sets output log file.
@@ -135,7 +632,11 @@ namespace logger{
          * @param[in] fmt Format to be applied.
          * 
         */
-        static void set_format_(structLogFormat &fmt);
+        static void set_format_(const structLogFormat &fmt);
+        friend class LogRecord;
+        friend class LogSink;
+        friend class ConsoleSink;
+        friend class FileSink;
     protected:
     
         /**
@@ -168,67 +669,70 @@ namespace logger{
         static Logger *getInstance();
         
         /**
-         * @brief This function logs input message. 
+         * @brief This function starts a log record with the log level and source set by set_log_level, and appends input to it.
          * 
-         * @param[in] s_ Input message
+         * Further inputs can be chained, and the record is emitted at the end of the statement.
          * 
-         * @return Pointer of Logger object
+         * @param[in] value Input message part (string, number, character, etc.)
          * 
-        */
-        Logger *operator<<(char *s_);
-                
-        /**
-         * @brief This function logs input message. 
-         * 
-         * @param[in] s_ Input message
-         * 
-         * @return Pointer of Logger object
+         * @return Log record
          * 
         */
-        Logger *operator<<(const std::string &s_);
-
+        template<typename T>
+        LogRecord operator<<(T &&value){
+            LogRecord record = start_record_();
+            record << std::forward<T>(value);
+            return record;
+        }
+        
         /**
-         * @brief This function logs input message. 
+         * @brief This function configure Logger class with provided configuration file. 
          * 
-         * @param[in] s_ Input message
+         * Levels, format, outputs and buffering are read from the YAML file, and the file is reloaded whenever it is changed.
          * 
-         * @return Pointer of Logger object
+         * @param[in] file_path Path of configuration file 
          * 
         */
-        Logger *operator<<(std::string &s_);
+        static void configure(const std::string file_path);
         
         /**
-         * @brief This function logs input message. 
+         * @brief This function configure Logger class with provided configuration file. 
          * 
-         * @param[in] s_ Input message
+         * Levels, format, outputs and buffering are read from the YAML file, and the file is reloaded whenever it is changed.
+         * 
+         * @param[in] file_path Path of configuration file 
          * 
-         * @return Pointer of Logger object
         */
-        Logger *operator<<(const char *s_);
-        
+        static void configure(char *file_path);
+
         /**
-         * @brief This function configure Logger class with provided configuration file. 
+         * @brief This function reads the configuration file again and applies it.
          * 
-         * @param[in] file_path Path of configuration file 
+         * If the file is not valid, the error is reported and the settings in use are kept.
+         * 
+         * @return True if the file is applied
          * 
         */
-        static void configure(const std::string file_path);
-        
+        static bool reload_config();
+
         /**
-         * @brief This function configure Logger class with provided configuration file. 
+         * @brief This function returns the configuration in use.
          * 
-         * @param[in] file_path Path of configuration file 
+         * Snapshots are immutable and live until the application exits, so the result can be read without locking.
+         * 
+         * @return Settings read from the configuration file. Nullptr if no configuration file is applied.
          * 
         */
-        static void configure(char *file_path);
+        static const structLogConfig *get_config() noexcept;
         
         /**
          * @brief This function sets log level of messages. 
          * 
          * Additional arguments (file and line) is used for traceback purposes of log message.
+         * The state is stored per thread, so concurrent log calls from different threads do not affect each other.
          * 
          * @param[in] level Log level enumeration of message (enumLogLevel::ERROR_, enumLogLevel::INFO_, etc.). 
-         * @param[in] file File path where the function is called. 
+         * @param[in] file File path where the function is called. It must have static storage duration (e.g. __FILE__).
          * @param[in] line Line number where the function is called. 
          * 
          * @return Pointer of Logger object
@@ -262,14 +766,26 @@ namespace logger{
         /**
          * @brief This function enables color feature of logs in console.
          * 
+         * It applies to console sinks whose colors are not set by ConsoleSink::set_colors.
+         * 
         */
-        static void enable_colors() noexcept;
+        static void enable_colors();
         
         /**
          * @brief This function disables color feature of logs in console.
          * 
+         * It applies to console sinks whose colors are not set by ConsoleSink::set_colors.
+         * 
+        */
+        static void disable_colors();
+
+        /**
+         * @brief This function routes console messages at or above the level to the standard error instead of the standard output.
+         * 
+         * @param[in] is_enabled True to route messages to the standard error
+         * @param[in] level Least severe level written to the standard error
         */
-        static void disable_colors() noexcept;
+        static void set_stderr_routing(bool is_enabled, enumLogLevel level=enumLogLevel::ERROR_) noexcept;
         
         /**
          * @brief This function sets thread safety by enabling or disabling the mutex.
@@ -283,7 +799,7 @@ namespace logger{
          * Source Field defines the location of where the log function is called.
          * 
         */
-        static void enable_source() noexcept;
+        static void enable_source();
         
         /**
          * @brief This function disables source field in the log.
@@ -291,7 +807,7 @@ namespace logger{
          * Source Field defines the location of where the log function is called.
          * 
         */
-        static void disable_source() noexcept;
+        static void disable_source();
         
         /**
          * @brief This function returns setted path of output log file.
@@ -302,6 +818,343 @@ namespace logger{
          *  
         */
         static std::string get_log_path() noexcept;
+
+        /**
+         * @brief This function adds a sink. Each message is written to every sink whose level accepts it.
+         * 
+         * Sinks can be added and removed while logging. The console sink and the file sink of set_output are added by default.
+         * 
+         * @param[in] sink Sink to be added (e.g. std::make_shared<FileSink>())
+         * 
+        */
+        static void add_sink(const std::shared_ptr<LogSink> &sink);
+
+        /**
+         * @brief This function removes a sink and closes it (e.g. the file of a FileSink).
+         * 
+         * The sink is not written anymore. It is released once every logging thread has moved to the new list of sinks.
+         * 
+         * @param[in] sink Sink to be removed
+         * 
+        */
+        static void remove_sink(const std::shared_ptr<LogSink> &sink);
+
+        /**
+         * @brief This function returns the default console sink.
+         * 
+         * @return Console sink
+        */
+        static std::shared_ptr<ConsoleSink> get_console_sink() noexcept;
+
+        /**
+         * @brief This function returns the default file sink that is opened by set_output.
+         * 
+         * @return File sink
+        */
+        static std::shared_ptr<FileSink> get_file_sink() noexcept;
+
+        /**
+         * @brief This function enables asynchronous logging.
+         * 
+         * Log calls only capture the message into a bounded wait-free buffer owned by the calling thread, and a
+         * dedicated writer thread merges the buffers of all threads in timestamp order and writes the messages
+         * to the console and the log file. Pending messages are drained when asynchronous logging is disabled
+         * or the application exits.
+         * 
+         * @param[in] capacity Number of messages the buffer of each thread can hold. Rounded up to the next power of two.
+         *                     It applies to buffers of threads that log for the first time after the call.
+         * @param[in] policy Behavior of log calls when the queue is full.
+         * 
+        */
+        static void enable_async(std::size_t capacity=DEFAULT_ASYNC_QUEUE_CAPACITY, enumOverflowPolicy policy=DEFAULT_ASYNC_OVERFLOW_POLICY);
+
+        /**
+         * @brief This function disables asynchronous logging.
+         * 
+         * It blocks until all queued messages are written and the writer thread is stopped.
+         * It should not be called while other threads are logging.
+         * 
+        */
+        static void disable_async();
+
+        /**
+         * @brief This function drains pending messages and stops the background threads.
+         * 
+         * The asynchronous writer writes queued messages until they are done or the timeout expires, then
+         * all sinks are flushed. It is called at normal exit with the default timeout. Log calls made
+         * afterwards are written on the calling thread.
+         * 
+         * @param[in] timeout_ms Longest time in milliseconds spent writing queued messages
+         * 
+         * @return True if all queued messages are written within the timeout
+         * 
+        */
+        static bool shutdown(uint32_t timeout_ms=DEFAULT_DRAIN_TIMEOUT_MS);
+
+        /**
+         * @brief This function enables or disables flushing of the logs on fatal signals.
+         * 
+         * On SIGSEGV, SIGABRT, SIGBUS and SIGFPE, queued messages are written by the writer thread if it
+         * responds within the timeout, and buffered content of the sinks is written with async-signal-safe
+         * calls. Then the previous handler is restored and the signal is raised again.
+         * 
+         * @param[in] enabled True to install the handlers, false to restore the previous ones
+         * 
+        */
+        static void set_crash_handler(bool enabled);
+
+        /**
+         * @brief This function returns whether asynchronous logging is enabled.
+         * 
+         * @return True if asynchronous logging is enabled
+         *  
+        */
+        static bool is_async_enabled() noexcept;
+
+        /**
+         * @brief This function sets when buffered content of the log file is written to the disk.
+         * 
+         * @param[in] policy Flush policy (enumFlushPolicy::ALWAYS, enumFlushPolicy::EVERY_N_BYTES, etc.)
+         * @param[in] threshold Number of bytes for EVERY_N_BYTES, number of milliseconds for EVERY_N_MS. Ignored for other policies.
+         * 
+        */
+        static void set_flush_policy(enumFlushPolicy policy, uint64_t threshold=DEFAULT_FLUSH_THRESHOLD);
+
+        /**
+         * @brief This function sets size of the buffer of the log file.
+         * 
+         * @param[in] size Buffer size in bytes. Zero disables buffering.
+         * 
+        */
+        static void set_file_buffer_size(std::size_t size);
+
+        /**
+         * @brief This function writes the log file through memory-mapped segments instead of the buffer.
+         * 
+         * Segments of the file are preallocated and mapped one at a time, so a message is only copied into mapped memory
+         * and the kernel writes it back. Until the file is closed, it is longer than its content and ends with zeros.
+         * It is not supported on Windows.
+         * 
+         * @param[in] segment_size Segment size in bytes. Zero switches back to buffered writes.
+         * 
+        */
+        static void set_file_segment_size(std::size_t segment_size=DEFAULT_FILE_SEGMENT_SIZE);
+
+        /**
+         * @brief This function sets when the log file is rotated and how many rotated files are kept.
+         * 
+         * The file is rotated once it reaches the maximum size or the time interval elapses. If timestamp prefix is enabled,
+         * the file also changes at local midnight. Rotated files are renamed as "<name>.<YYYYmmdd-HHMMSS-fff><extension>",
+         * and the oldest ones beyond the limit are deleted by a background thread.
+         * 
+         * @param[in] policy Rotation policy. Default policy disables rotation.
+         * 
+        */
+        static void set_rotation(const structRotationPolicy &policy);
+
+        /**
+         * @brief This function sets how many records are gathered before the console and the log file are written.
+         * 
+         * Formatted records are collected and written with a single system call per batch. A batch is written when it
+         * reaches the maximum number of records, when its oldest record is older than the latency bound, or when the
+         * asynchronous writer runs out of queued messages. Output bytes are not changed.
+         * 
+         * @param[in] max_records Maximum number of records per batch. One writes every record immediately.
+         * @param[in] max_latency_us Maximum time in microseconds a record waits in the batch. Zero disables the bound.
+         * 
+        */
+        static void set_batch_policy(uint32_t max_records, uint64_t max_latency_us=DEFAULT_BATCH_MAX_LATENCY_US);
+
+        /**
+         * @brief This function writes buffered content of all sinks and the binary log file.
+         * 
+         * Pending "Last message repeated N times" summaries are emitted first.
+         * 
+        */
+        static void flush();
+
+        /**
+         * @brief This function enables or disables folding of consecutive identical messages of a call site.
+         * 
+         * Repeats of the last message of a call site at the same level are not written. Instead,
+         * "Last message repeated N times" is written when the message changes, when the interval
+         * has passed since the first repeat, or when flush is called. Summaries of call sites that
+         * stop logging are written by the housekeeping thread within about two intervals.
+         * 
+         * @param[in] enabled True to fold repeated messages
+         * @param[in] interval_ms Longest time in milliseconds repeats are held before the summary is written. Zero waits until the message changes.
+         * 
+        */
+        static void set_duplicate_suppression(bool enabled, uint32_t interval_ms=DEFAULT_DUPLICATE_INTERVAL_MS);
+
+        /**
+         * @brief This function sets the maximum size of messages.
+         * 
+         * Longer messages are cut at the size and end with DEFAULT_TRUNCATION_MARKER. Since records and messages reuse
+         * their storage, bounded messages are logged without allocating memory once the storage has grown.
+         * 
+         * @param[in] size Maximum size in bytes. Sizes below DEFAULT_RECORD_BUFFER_SIZE are raised to it. Zero disables truncation.
+         * 
+        */
+        static void set_max_message_size(std::size_t size) noexcept;
+
+        /**
+         * @brief This function returns a snapshot of runtime metrics of the logger.
+         * 
+         * Message counts and formatting time are kept per thread and aggregated here, so counting does not
+         * slow down log calls. It can be called from any thread while logging continues.
+         * 
+         * @return Snapshot of the metrics
+         *  
+        */
+        static structLoggerStats stats();
+
+        /**
+         * @brief This function returns number of messages dropped because the asynchronous queue was full.
+         * 
+         * @return Number of dropped messages
+         *  
+        */
+        static uint64_t get_dropped_count() noexcept;
+
+        /**
+         * @brief This function sets runtime log level threshold.
+         * 
+         * Messages with less severe level than the threshold are discarded before the timestamp is taken or the message is formatted.
+         * 
+         * @param[in] level Least severe log level to be logged (e.g. enumLogLevel::INFO_ discards DEBUG and TRACE messages).
+         * 
+        */
+        static void set_log_threshold(enumLogLevel level);
+
+        /**
+         * @brief This function returns runtime log level threshold.
+         * 
+         * @return Least severe log level to be logged
+         *  
+        */
+        static enumLogLevel get_log_threshold() noexcept;
+
+        /**
+         * @brief This function checks whether messages of the log level pass the runtime threshold.
+         * 
+         * @param[in] level Log level enumeration of message
+         * 
+         * @return True if messages of the level are logged
+         *  
+        */
+        static inline bool is_level_enabled(enumLogLevel level) noexcept{
+            return get_settings()->is_level_enabled(level);
+        }
+
+        /**
+         * @brief This function returns the runtime settings read by log calls.
+         * 
+         * Threshold, format, source and color settings are published together as an immutable snapshot that lives until the
+         * application exits, so log macros read it once per call and every part of the message uses the same settings.
+         * 
+         * @return Snapshot of the settings
+         *  
+        */
+        static inline const structLogSettings *get_settings() noexcept{
+            return settings_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief This function returns the handle of a named category, and creates the category and its parents if they do not exist.
+         * 
+         * Names are hierarchical with dot separated parts (e.g. "net.tcp" is a child of "net"). A category without its own level
+         * follows its parent, and top-level categories follow the runtime threshold.
+         * 
+         * @param[in] name Name of the category
+         * 
+         * @return Handle of the category. It is valid until the application exits.
+         *  
+        */
+        static LogCategory get(std::string_view name);
+
+        /**
+         * @brief This function sets the level of a category. Its children without their own level follow it.
+         * 
+         * @param[in] name Name of the category
+         * @param[in] level Least severe log level to be logged in the category
+         * 
+        */
+        static void set_category_level(std::string_view name, enumLogLevel level);
+
+        /**
+         * @brief This function removes the level of a category, so it follows its parent again.
+         * 
+         * @param[in] name Name of the category
+         * 
+        */
+        static void reset_category_level(std::string_view name);
+
+        /**
+         * @brief This function sets output file of binary log records.
+         * 
+         * Once it is set, LogXxxBin macros store only timestamp, call site id and raw arguments to the file.
+         * Use logger-decode tool to convert the file to text.
+         * 
+         * @param[in] filename Filename of binary log file.
+         * @param[in] file_dir Directory of binary log file. Leave empty if home location is desired. 
+         * 
+        */
+        static void set_binary_output(const std::string &filename, const std::string file_dir="");
+
+        /**
+         * @brief This function assigns an id to the call site. It is called once per call site by LogXxxBin macros.
+         * 
+         * @param[in] site Call site
+         * 
+         * @return Id of the call site
+         *  
+        */
+        static uint32_t register_call_site(const structCallSite &site) noexcept;
+
+        /**
+         * @brief This function logs "{}" formatted arguments of the call site.
+         * 
+         * If binary output is set, arguments are written raw to the binary log file. Otherwise, message is formatted and logged as text.
+         * 
+         * @param[in] site Call site
+         * @param[in] site_id Id of the call site
+         * @param[in] settings Settings read by the log call (e.g. Logger::get_settings())
+         * @param[in] fmt Format string with "{}" placeholders
+         * @param[in] args Arguments to be formatted
+         * 
+        */
+        template<typename... Args>
+        static void log_binary(const structCallSite &site, uint32_t site_id, const structLogSettings *settings, const char *fmt, const Args&... args){
+            (void) fmt;
+            thread_local std::string payload;
+            payload.clear();
+            (encode_binary_arg(payload, args), ...);
+
+            if (is_binary_enabled_.load(std::memory_order_acquire)) write_binary_record_(site, site_id, *settings, payload);
+            else log_formatted_(site, *settings, payload);
+        }
+
+        /**
+         * @brief This function returns log message structure as a text line, in the same form it is written to the log file.
+         * 
+         * @param[in] msg_log Message structure
+         * 
+         * @return Log line
+         *  
+        */
+        static std::string format(const structLogMsg &msg_log);
+
+        /**
+         * @brief This function sets log format of the sinks that do not have their own format.
+         * 
+         * Timestamp format is parsed once here. Besides "%Y %m %d %H %M %S %f" patterns, ISO8601_UTC_TIMESTAMP_FORMAT
+         * and EPOCH_NS_TIMESTAMP_FORMAT can be used.
+         * 
+         * @param[in] fmt Format to be applied.
+         * 
+        */
+        static void set_format(const structLogFormat &fmt);
     };
 }
 
@@ -0,0 +1,213 @@
+#ifndef LOGGER_BINARY_H
+#define LOGGER_BINARY_H
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <charconv>
+#include <type_traits>
+
+#include "logger_defs.h"
+
+namespace logger{
+
+    // Binary log files start with the magic, the version and the byte order mark
+    #define BINARY_LOG_MAGIC            "LGBN"
+    #define BINARY_LOG_VERSION          1
+    #define BINARY_LOG_BYTE_ORDER_MARK  0x01020304u
+
+    // Entry kinds of binary log files
+    #define BINARY_ENTRY_CALL_SITE      'S'
+    #define BINARY_ENTRY_RECORD         'R'
+
+    // Record flags of binary log files
+    #define BINARY_FLAG_SOURCE_ENABLED  0x01
+
+    /**
+     * @struct structCallSite
+     *
+     * @brief This struct defines static metadata of a log call site. It is registered once and referred by its id.
+    */
+    struct structCallSite{
+        enumLogLevel log_level;     ///< Log Level
+        const char *file;           ///< File where the log function is called
+        int line;                   ///< Line where the log function is called
+        const char *fmt;            ///< Format string with "{}" placeholders
+        const structSourceLocation *location;   ///< Source location used when the record is logged as text
+    };
+
+    /**
+     * @enum enumBinaryArgType
+     *
+     * @brief This enum defines type tags of arguments stored in binary log records
+    */
+    enum class enumBinaryArgType: uint8_t{
+        INT64 = 1,
+        UINT64 = 2,
+        DOUBLE = 3,
+        BOOL = 4,
+        CHAR = 5,
+        STRING = 6
+    };
+
+    /**
+     * @brief This function appends raw bytes of a trivially copyable value to the buffer.
+     *
+     * @param[in] out Output buffer
+     * @param[in] value Value to be appended
+     *
+    */
+    template<typename T>
+    inline void append_binary(std::string &out, const T &value){
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be appended.");
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /**
+     * @brief This function reads raw bytes of a trivially copyable value from the buffer.
+     *
+     * @param[in] data Input buffer
+     * @param[in] size Size of input buffer
+     * @param[in] pos Read position. It is advanced by size of the value.
+     * @param[out] value Read value
+     *
+     * @return True if the buffer holds enough bytes
+    */
+    template<typename T>
+    inline bool read_binary(const char *data, std::size_t size, std::size_t &pos, T &value){
+        if (pos + sizeof(T) > size) return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    /**
+     * @brief This function appends a tagged argument to the binary record payload.
+     *
+     * Integers are widened to 64 bits, floating point numbers are stored as double, and strings are stored with their length.
+     *
+     * @param[in] out Output payload
+     * @param[in] value Argument value
+     *
+    */
+    template<typename T>
+    inline void encode_binary_arg(std::string &out, const T &value){
+        using U = typename std::decay<T>::type;
+        if constexpr (std::is_same<U, bool>::value){
+            append_binary(out, enumBinaryArgType::BOOL);
+            append_binary(out, (uint8_t) value);
+        }
+        else if constexpr (std::is_same<U, char>::value){
+            append_binary(out, enumBinaryArgType::CHAR);
+            append_binary(out, value);
+        }
+        else if constexpr (std::is_integral<U>::value && std::is_signed<U>::value){
+            append_binary(out, enumBinaryArgType::INT64);
+            append_binary(out, (int64_t) value);
+        }
+        else if constexpr (std::is_integral<U>::value || std::is_enum<U>::value){
+            append_binary(out, enumBinaryArgType::UINT64);
+            append_binary(out, (uint64_t) value);
+        }
+        else if constexpr (std::is_floating_point<U>::value){
+            append_binary(out, enumBinaryArgType::DOUBLE);
+            append_binary(out, (double) value);
+        }
+        else{
+            std::string_view str(value);
+            append_binary(out, enumBinaryArgType::STRING);
+            append_binary(out, (uint32_t) str.size());
+            out.append(str.data(), str.size());
+        }
+    }
+
+    /**
+     * @brief This function decodes a tagged argument from the binary record payload and appends its text form.
+     *
+     * @param[in] data Payload
+     * @param[in] size Size of payload
+     * @param[in] pos Read position. It is advanced past the argument.
+     * @param[in] out Output text
+     *
+     * @return True if the argument is decoded
+    */
+    inline bool decode_binary_arg(const char *data, std::size_t size, std::size_t &pos, std::string &out){
+        enumBinaryArgType type;
+        if (!read_binary(data, size, pos, type)) return false;
+
+        char num[32];
+        std::to_chars_result r{num, std::errc()};
+        switch (type){
+            case enumBinaryArgType::INT64: {
+                int64_t v;
+                if (!read_binary(data, size, pos, v)) return false;
+                r = std::to_chars(num, num + sizeof(num), v);
+                break;
+            }
+            case enumBinaryArgType::UINT64: {
+                uint64_t v;
+                if (!read_binary(data, size, pos, v)) return false;
+                r = std::to_chars(num, num + sizeof(num), v);
+                break;
+            }
+            case enumBinaryArgType::DOUBLE: {
+                double v;
+                if (!read_binary(data, size, pos, v)) return false;
+                r = std::to_chars(num, num + sizeof(num), v);
+                break;
+            }
+            case enumBinaryArgType::BOOL: {
+                uint8_t v;
+                if (!read_binary(data, size, pos, v)) return false;
+                out += v? "true": "false";
+                return true;
+            }
+            case enumBinaryArgType::CHAR: {
+                char v;
+                if (!read_binary(data, size, pos, v)) return false;
+                out.push_back(v);
+                return true;
+            }
+            case enumBinaryArgType::STRING: {
+                uint32_t len;
+                if (!read_binary(data, size, pos, len) || pos + len > size) return false;
+                out.append(data + pos, len);
+                pos += len;
+                return true;
+            }
+            default:
+                return false;
+        }
+        out.append(num, r.ptr);
+        return true;
+    }
+
+    /**
+     * @brief This function renders the message of a binary record by substituting "{}" placeholders of the format string.
+     *
+     * "{{" and "}}" are written as literal braces. Placeholders without arguments are written as they are.
+     *
+     * @param[in] fmt Format string of the call site
+     * @param[in] data Payload holding tagged arguments
+     * @param[in] size Size of payload
+     * @param[in] out Output message
+     *
+     * @return True if all arguments are decoded
+    */
+    inline bool format_binary_args(const char *fmt, const char *data, std::size_t size, std::string &out){
+        std::size_t pos = 0;
+        for (const char *p = fmt; *p != '\0'; p++){
+            if (p[0] == '{' && p[1] == '{'){ out.push_back('{'); p++; }
+            else if (p[0] == '}' && p[1] == '}'){ out.push_back('}'); p++; }
+            else if (p[0] == '{' && p[1] == '}' && pos < size){
+                if (!decode_binary_arg(data, size, pos, out)) return false;
+                p++;
+            }
+            else out.push_back(*p);
+        }
+        return true;
+    }
+}
+
+#endif  // LOGGER_BINARY_H
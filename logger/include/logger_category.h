@@ -0,0 +1,80 @@
+#ifndef LOGGER_CATEGORY_H
+#define LOGGER_CATEGORY_H
+
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include "logger_defs.h"
+
+namespace logger{
+
+    // Level of a category that has no level of its own. It follows its parent, and top-level categories follow the runtime threshold.
+    #define LOGGER_CATEGORY_INHERIT_LEVEL   -1
+
+    /**
+     * @struct structCategoryNode
+     *
+     * @brief This struct defines a named category of log messages. Categories are created once and live until the application exits.
+    */
+    struct structCategoryNode{
+        std::string name;                                   ///< Dot separated name (e.g. "net.tcp")
+        structCategoryNode *parent = nullptr;               ///< Category of the name without its last part. Null for top-level categories.
+        int own_level = LOGGER_CATEGORY_INHERIT_LEVEL;      ///< Level set for the category. Guarded by the category registry of Logger.
+        std::atomic<int> level{(int) enumLogLevel::TRACE_}; ///< Effective level, resolved from the hierarchy whenever a level changes
+    };
+
+    /**
+     * @class LogCategory
+     *
+     * @brief This class is a handle of a named category returned by Logger::get.
+     *
+     * The name is looked up once when the handle is created. Level checks read the effective level of the category with a single load,
+     * so handles are meant to be kept (e.g. in a static or a member) and copied freely.
+     *
+    */
+    class LogCategory{
+    private:
+        const structCategoryNode *node_;
+
+    public:
+        /**
+         * @brief Constructor of the class.
+         *
+         * @param[in] node Category of the handle. It must outlive the handle.
+        */
+        explicit LogCategory(const structCategoryNode *node) noexcept: node_(node){
+        }
+
+        /**
+         * @brief This function checks whether messages of the log level pass the level of the category.
+         *
+         * @param[in] level Log level enumeration of message
+         *
+         * @return True if messages of the level are logged
+        */
+        inline bool is_level_enabled(enumLogLevel level) const noexcept{
+            return (int) level <= node_->level.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief This function returns the effective level of the category.
+         *
+         * @return Least severe log level to be logged in the category
+        */
+        enumLogLevel get_level() const noexcept{
+            return (enumLogLevel) node_->level.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief This function returns the name of the category.
+         *
+         * @return Name of the category. It is valid until the application exits.
+        */
+        std::string_view name() const noexcept{
+            return node_->name;
+        }
+    };
+}
+
+#endif // LOGGER_CATEGORY_H
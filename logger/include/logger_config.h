@@ -0,0 +1,81 @@
+#ifndef LOGGER_CONFIG_H
+#define LOGGER_CONFIG_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "logger_defs.h"
+#include "logger_format.h"
+
+namespace logger{
+
+    // Bits of structLogConfig::keys, one per key of the configuration file
+    #define CONFIG_KEY_LEVEL                  (1u << 0)
+    #define CONFIG_KEY_SOURCE                 (1u << 1)
+    #define CONFIG_KEY_COLORS                 (1u << 2)
+    #define CONFIG_KEY_FORMAT_TIMESTAMP       (1u << 3)
+    #define CONFIG_KEY_FORMAT_DELIMITER       (1u << 4)
+    #define CONFIG_KEY_FORMAT_OUTPUT          (1u << 5)
+    #define CONFIG_KEY_FORMAT_PADDING         (1u << 6)
+    #define CONFIG_KEY_FILE_NAME              (1u << 7)
+    #define CONFIG_KEY_FILE_DIR               (1u << 8)
+    #define CONFIG_KEY_FILE_TIMESTAMP_PREFIX  (1u << 9)
+    #define CONFIG_KEY_FLUSH_POLICY           (1u << 10)
+    #define CONFIG_KEY_FLUSH_THRESHOLD        (1u << 11)
+    #define CONFIG_KEY_FILE_BUFFER_SIZE       (1u << 12)
+    #define CONFIG_KEY_BATCH_MAX_RECORDS      (1u << 13)
+    #define CONFIG_KEY_BATCH_MAX_LATENCY_US   (1u << 14)
+
+    /**
+     * @struct structLogConfig
+     *
+     * @brief This struct defines the settings read from a configuration file
+     *
+     * A snapshot is never modified once it is published, so it can be read without locking. Fields of keys missing
+     * from the file keep their default values here, but they are not applied, so the settings in use are left as they are.
+     *
+    */
+    struct structLogConfig{
+        uint32_t keys = 0;                                                  ///< Keys set by the file (CONFIG_KEY_LEVEL, etc.)
+        enumLogLevel level_threshold = enumLogLevel::TRACE_;                ///< Messages above this level are discarded
+        bool is_source_enabled = false;                                     ///< Whether source field is shown
+        bool is_colors_enabled = false;                                     ///< Whether console lines are colored
+        structLogFormat format{DEFAULT_TIMESTAMP_FORMAT, DEFAULT_DELIMITER_TYPE, DEFAULT_PADDING_SIZE, enumOutputFormat::TEXT};  ///< Log format
+        std::string output_filename;                                        ///< Filename of the log file. Empty if it is not set by the file.
+        std::string output_dir;                                             ///< Directory of the log file
+        bool is_timestamp_prefix_enabled = false;                           ///< Whether timestamp is added to the filename
+        enumFlushPolicy flush_policy = DEFAULT_FLUSH_POLICY;                ///< Flush policy of the log file
+        uint64_t flush_threshold = DEFAULT_FLUSH_THRESHOLD;                 ///< Threshold of the flush policy
+        std::size_t file_buffer_size = DEFAULT_FILE_BUFFER_SIZE;            ///< Buffer size of the log file
+        uint32_t batch_max_records = DEFAULT_BATCH_MAX_RECORDS;             ///< Records written at once
+        uint64_t batch_max_latency_us = DEFAULT_BATCH_MAX_LATENCY_US;       ///< Longest time a record waits in a batch
+    };
+
+    /**
+     * @brief This function parses configuration in YAML format.
+     *
+     * Only the subset used by the configuration is supported: "key: value" pairs, nested by indentation with spaces,
+     * quoted or plain scalar values, and comments starting with '#'.
+     *
+     * @param[in] text Content of the configuration file
+     * @param[out] config Parsed settings. It is modified only if the whole text is valid.
+     * @param[out] error Reason of the failure
+     *
+     * @return True if the text is valid
+    */
+    bool parse_config(const std::string &text, structLogConfig &config, std::string &error);
+
+    /**
+     * @brief This function reads configuration file in YAML format (.yaml or .yml).
+     *
+     * @param[in] file_path Path of the configuration file
+     * @param[out] config Parsed settings. It is modified only if the whole file is valid.
+     * @param[out] error Reason of the failure
+     *
+     * @return True if the file is read and valid
+    */
+    bool read_config_file(const std::string &file_path, structLogConfig &config, std::string &error);
+}
+
+#endif  // LOGGER_CONFIG_H
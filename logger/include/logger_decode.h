@@ -0,0 +1,33 @@
+#ifndef LOGGER_DECODE_H
+#define LOGGER_DECODE_H
+
+#include <string>
+#include <cstddef>
+
+namespace logger{
+
+    /**
+     * @brief This function checks the magic, the version and the byte order mark of a binary log file.
+     *
+     * @param[in] data Content of the binary log file
+     * @param[out] pos Position of the first entry
+     *
+     * @return True if the data starts with a valid header
+    */
+    bool decode_binary_header(const std::string &data, std::size_t &pos);
+
+    /**
+     * @brief This function converts entries of a binary log file to text lines, in the same form they are written to the log file.
+     *
+     * Decoding stops at the first entry that is truncated or corrupted, and lines of the preceding records are kept.
+     *
+     * @param[in] data Content of the binary log file
+     * @param[in] pos Position of the first entry (see decode_binary_header). It is advanced past the decoded entries.
+     * @param[in] out Output text. Decoded lines are appended.
+     *
+     * @return True if all entries are decoded
+    */
+    bool decode_binary_entries(const std::string &data, std::size_t &pos, std::string &out);
+}
+
+#endif  // LOGGER_DECODE_H
@@ -3,6 +3,9 @@
 
 #include <map>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <chrono>
 
 
 // Define platform-specific macros
@@ -81,6 +84,9 @@ namespace logger{
         INVALID_ = 8
     };
 
+    // Number of log levels in enumLogLevel
+    #define LOG_LEVEL_COUNT 9
+
     /**
      * @enum enumDelimiterType
      * 
@@ -110,6 +116,104 @@ namespace logger{
         CUSTOM = -1
     };
 
+    /**
+     * @enum enumOutputFormat
+     * 
+     * @brief This enum defines how log messages are written as lines
+    */
+    enum class enumOutputFormat{
+        TEXT,   ///< Fields separated by the delimiter
+        JSON    ///< One JSON object per line
+    };
+
+    /**
+     * @enum enumFieldKind
+     * 
+     * @brief This enum defines how the value of a structured field is written to JSON lines
+    */
+    enum class enumFieldKind: char{
+        STRING = 's',   ///< Quoted and escaped
+        LITERAL = 'l'   ///< Written as it is (numbers and booleans)
+    };
+
+    /**
+     * @enum enumOverflowPolicy
+     * 
+     * @brief This enum defines what producers do when the asynchronous queue is full
+    */
+    enum class enumOverflowPolicy{
+        BLOCK,  ///< Wait until the writer thread frees a slot
+        DROP    ///< Discard the message and count it as dropped
+    };
+
+    /**
+     * @enum enumFlushPolicy
+     * 
+     * @brief This enum defines when buffered log file content is written to the disk
+    */
+    enum class enumFlushPolicy{
+        ALWAYS,         ///< Flush after every message
+        EVERY_N_BYTES,  ///< Flush when buffered content reaches the threshold in bytes
+        EVERY_N_MS,     ///< Flush when the threshold in milliseconds has passed since the last flush
+        ON_ERROR        ///< Flush on ERROR and FATAL messages
+    };
+
+    /**
+     * @struct structRotationPolicy
+     *
+     * @brief This struct defines when the log file is rotated and how many rotated files are kept
+    */
+    struct structRotationPolicy{
+        uint64_t max_file_size = 0;     ///< Rotate once the file reaches this size in bytes. Zero disables size-based rotation.
+        uint32_t interval_sec = 0;      ///< Rotate at multiples of this interval since epoch. Zero disables time-based rotation.
+        uint32_t max_files = 0;         ///< Number of rotated files to keep. Zero keeps all of them.
+    };
+
+    /**
+     * @struct structOutputBatch
+     *
+     * @brief This struct keeps the state of records written to an output but not yet committed
+    */
+    struct structOutputBatch{
+        uint32_t records = 0;                               ///< Number of pending records
+        std::chrono::steady_clock::time_point start{};      ///< Time when the first pending record was written
+    };
+
+    /**
+     * @struct structPruneRequest
+     *
+     * @brief This struct defines which rotated log files are checked by the housekeeping thread
+    */
+    struct structPruneRequest{
+        std::string file_dir;           ///< Directory of log files
+        std::string root_filename;      ///< Filename of the log file without timestamp prefix
+        std::string active_filename;    ///< Filename of the log file being written. It is never deleted.
+        uint32_t max_files = 0;         ///< Number of rotated files to keep
+    };
+
+    // Number of buckets of the flush latency histogram. Bucket i counts flushes shorter than 2^(i+1) microseconds, the last one counts the rest.
+    #define LOGGER_FLUSH_HISTOGRAM_BUCKETS 16
+
+    /**
+     * @struct structLoggerStats
+     *
+     * @brief This struct defines a snapshot of runtime metrics of the logger
+    */
+    struct structLoggerStats{
+        uint64_t level_counts[LOG_LEVEL_COUNT] = {};                        ///< Logged messages per level, indexed by enumLogLevel
+        uint64_t console_bytes = 0;                                         ///< Bytes written by the console sink
+        uint64_t file_bytes = 0;                                            ///< Bytes written by the default file sink
+        uint64_t binary_bytes = 0;                                          ///< Bytes written to the binary log file
+        uint64_t flush_count = 0;                                           ///< Number of flushes that wrote buffered content
+        uint64_t flush_latency_histogram[LOGGER_FLUSH_HISTOGRAM_BUCKETS] = {};  ///< Flush durations in power-of-two microsecond buckets
+        uint64_t format_time_ns = 0;                                        ///< Time spent formatting lines, estimated from every 16th message
+        uint64_t queue_high_water = 0;                                      ///< Most messages waiting for the asynchronous writer at once
+        uint64_t dropped_count = 0;                                         ///< Messages dropped because the asynchronous buffer was full
+        uint64_t suppressed_count = 0;                                      ///< Calls suppressed by rate limited or sampled macros
+        uint64_t duplicate_count = 0;                                       ///< Repeated messages folded by duplicate suppression
+        uint64_t error_count = 0;                                           ///< Internal errors of the logger
+    };
+
     /**
      * @struct structLogFormat
      * 
@@ -119,6 +223,20 @@ namespace logger{
         std::string fmt_timestamp = "";                                     ///< Timestamp format
         enumDelimiterType fmt_delimiter_type = enumDelimiterType::DEFAULT;  ///< Delimiter type
         enumPaddingSize fmt_padding_size = enumPaddingSize::DEFAULT;        ///< Padding size
+        enumOutputFormat fmt_output = enumOutputFormat::TEXT;               ///< Line format
+    };
+
+    /**
+     * @struct structLineLayout
+     * 
+     * @brief This struct defines pre-rendered parts of log lines. It is compiled from the log format once.
+    */
+    struct structLineLayout{
+        bool has_timestamp = true;                      ///< Whether lines start with timestamp field
+        std::string separator;                          ///< Padding and delimiter placed before each field except the first one
+        std::string level_tags[LOG_LEVEL_COUNT];        ///< Level field of each level, with its leading separator
+        std::string level_names[LOG_LEVEL_COUNT];       ///< Name of each level
+        std::string newline;                            ///< Line ending
     };
 
     /**
@@ -141,6 +259,65 @@ namespace logger{
         int tm_wday=0;		///< Day of week.	[0-6]
         int tm_yday=0;		///< Days in year.[0-365]
         int tm_isdst=0;		///< DST.		[-1/0/1]
+        int64_t tm_epoch_ns=0;	///< Nanoseconds since epoch. Zero if the timestamp is not derived from the clock.
+    };
+
+    /**
+     * @struct structSourceLocation
+     * 
+     * @brief This struct defines a call site with its source field rendered once
+     * 
+     * Log macros keep it in a static constant built at compile time, so log records only refer to it.
+     * 
+    */
+    struct structSourceLocation{
+        const char *file;       ///< File where the log function is called (e.g. __FILE__)
+        int line;               ///< Line where the log function is called
+        const char *text;       ///< Source field as "basename:line"
+        uint32_t text_size;     ///< Length of the source field
+    };
+
+    /**
+     * @struct structLogContext
+     * 
+     * @brief This struct defines the state of the log message being built on a thread
+     * 
+     * It is set by set_log_level and consumed by the following log call on the same thread.
+     * 
+    */
+    struct structLogContext{
+        enumLogLevel log_level = enumLogLevel::INFO_;   ///< Log Level
+        const char *source_file = "";                   ///< File where the log function is called (e.g. __FILE__)
+        int source_line = 0;                            ///< Line where the log function is called
+    };
+
+    // Formatter of log lines. It is defined in logger_sink.h.
+    class LineFormatter;
+
+    /**
+     * @struct structLogSettings
+     * 
+     * @brief This struct defines the runtime settings read by log calls
+     * 
+     * Settings are published together as an immutable snapshot, so a log call reads all of them with a single atomic load.
+     * 
+    */
+    struct structLogSettings{
+        int level_threshold = (int) enumLogLevel::TRACE_;   ///< Least severe log level to be logged
+        const LineFormatter *formatter = nullptr;           ///< Formatter of the sinks that do not have their own format
+        bool is_source_enabled = false;                     ///< Whether source field is shown
+        bool is_colors_enabled = false;                     ///< Whether console lines are colored
+
+        /**
+         * @brief This function checks whether messages of the log level pass the threshold.
+         * 
+         * @param[in] level Log level enumeration of message
+         * 
+         * @return True if messages of the level are logged
+        */
+        inline bool is_level_enabled(enumLogLevel level) const noexcept{
+            return (int) level <= level_threshold;
+        }
     };
 
     /**
@@ -152,8 +329,11 @@ namespace logger{
         structTimestamp timestamp;      ///< Timestamp
         enumLogLevel log_level;     ///< Log Level
         std::string log_level_desc; ///< Custom Log Level Description
-        std::string source;         ///< Source of Log Message
+        const structSourceLocation *source = nullptr;   ///< Source of Log Message. Null if source is not shown.
+        std::string_view category;  ///< Name of the category. Empty for messages of the global logger.
+        const structLogSettings *settings = nullptr;    ///< Settings read by the log call. Null if the current settings are used.
         std::string msg;            ///< Message
+        std::string fields;         ///< Structured fields packed by LogRecord::kv. Read with for_each_field.
     };
 }
 
@@ -0,0 +1,196 @@
+#ifndef LOGGER_FILE_H
+#define LOGGER_FILE_H
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace logger{
+
+    /**
+     * @class LogFile
+     *
+     * @brief This class keeps a log file open and buffers written data in user space.
+     *
+     * Data is written to the file descriptor only when the buffer is full or flush() is called,
+     * so a log message costs a memory copy instead of open/write/close system calls.
+     *
+     * Alternatively, the file can be written through memory-mapped segments. Fixed-size segments are preallocated
+     * and mapped one at a time, and written data is copied into the mapping, so writes need no system call
+     * until the segment is full. The file is truncated to its real length when it is closed. If a segment cannot be
+     * mapped (e.g. its blocks cannot be reserved on a full disk), the file continues with buffered writes.
+     *
+    */
+    class LogFile{
+    private:
+        int fd_;
+        bool is_owned_;
+        std::string path_;
+        std::unique_ptr<char[]> buffer_;
+        std::size_t capacity_;
+        std::size_t used_;
+        uint64_t file_size_;
+
+        std::size_t segment_size_;
+        char *segment_;
+        uint64_t segment_offset_;
+        std::size_t segment_used_;
+
+        /**
+         * @brief This private function writes data to the file descriptor without buffering.
+         *
+         * @param[in] data Data to be written
+         * @param[in] size Size of data in bytes
+         *
+         * @return True on success
+        */
+        bool write_fd_(const char *data, std::size_t size);
+
+        /**
+         * @brief This private function preallocates and maps the segment of the file that holds the offset.
+         *
+         * Previously mapped segment is unmapped.
+         *
+         * @param[in] offset File offset to be written next
+         *
+         * @return True on success
+        */
+        bool map_segment_(uint64_t offset);
+
+        /**
+         * @brief This private function unmaps the current segment.
+        */
+        void unmap_segment_();
+
+        /**
+         * @brief This private function switches the file from memory-mapped segments to buffered writes.
+         *
+         * @return True on success
+        */
+        bool fall_back_to_buffer_();
+
+    public:
+        /**
+         * @brief Constructor of the class.
+         *
+         * @param[in] buffer_size Size of the user-space buffer in bytes
+        */
+        explicit LogFile(std::size_t buffer_size);
+
+        /**
+         * @brief Constructor of the class. Attaches to a file descriptor that is already open (e.g. standard output).
+         *
+         * The file descriptor is not closed by the class.
+         *
+         * @param[in] buffer_size Size of the user-space buffer in bytes
+         * @param[in] fd Open file descriptor
+        */
+        LogFile(std::size_t buffer_size, int fd);
+
+        /**
+         * @brief Destructor of the class. Flushes pending data and closes the file.
+        */
+        ~LogFile();
+
+        LogFile(const LogFile &obj) = delete;
+        void operator=(const LogFile &obj) = delete;
+
+        /**
+         * @brief This function opens the file. Previously opened file is flushed and closed.
+         *
+         * @param[in] path Path of the file
+         * @param[in] truncate If true, content of the existing file is discarded. Otherwise, data is appended.
+         *
+         * @return True if the file is opened
+        */
+        bool open(const std::string &path, bool truncate=false);
+
+        /**
+         * @brief This function flushes pending data and closes the file.
+        */
+        void close();
+
+        /**
+         * @brief This function returns whether the file is open.
+         *
+         * @return True if the file is open
+        */
+        bool is_open() const noexcept;
+
+        /**
+         * @brief This function appends data to the buffer. The buffer is written to the file when it is full.
+         *
+         * If the data does not fit, pending bytes and the data are written together with a single vectored write.
+         *
+         * @param[in] data Data to be written
+         * @param[in] size Size of data in bytes
+         *
+         * @return True on success
+        */
+        bool write(const char *data, std::size_t size);
+
+        /**
+         * @brief This function writes buffered data to the file.
+         *
+         * @return True on success
+        */
+        bool flush();
+
+        /**
+         * @brief This function writes buffered data to the file from a signal handler.
+         *
+         * It only calls async-signal-safe functions. Mapped files are truncated to their written length,
+         * since the mapping is not closed.
+        */
+        void flush_on_crash() noexcept;
+
+        /**
+         * @brief This function changes size of the buffer. Pending data is flushed first.
+         *
+         * @param[in] buffer_size Size of the buffer in bytes. Zero disables buffering.
+        */
+        void set_buffer_size(std::size_t buffer_size);
+
+        /**
+         * @brief This function sets size of memory-mapped segments. Open file is reopened in the new mode.
+         *
+         * Memory-mapped writing is not supported on Windows.
+         *
+         * @param[in] segment_size Segment size in bytes, rounded up to the page size. Zero disables memory mapping.
+         *
+         * @return True on success
+        */
+        bool set_segment_size(std::size_t segment_size);
+
+        /**
+         * @brief This function returns whether the file is written through memory-mapped segments.
+         *
+         * @return True if memory mapping is enabled
+        */
+        bool is_mapped() const noexcept;
+
+        /**
+         * @brief This function returns number of bytes waiting in the buffer.
+         *
+         * @return Number of buffered bytes
+        */
+        std::size_t buffered_size() const noexcept;
+
+        /**
+         * @brief This function returns size of the file including buffered data.
+         *
+         * @return Size of the file in bytes
+        */
+        uint64_t file_size() const noexcept;
+
+        /**
+         * @brief This function returns path of the open file.
+         *
+         * @return Path of the file. Empty if no file is open.
+        */
+        const std::string &path() const noexcept;
+    };
+}
+
+#endif  // LOGGER_FILE_H
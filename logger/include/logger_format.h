@@ -9,9 +9,57 @@ namespace logger{
     // Define default log formats
     #define DEFAULT_TIMESTAMP_FORMAT        "%Y-%m-%d %H:%M:%S.%f"
     #define DEFAULT_TIMESTAMP_PREFIX_FORMAT "%Y%m%d"
+    #define ISO8601_UTC_TIMESTAMP_FORMAT    "%iso8601"      // e.g. 2024-01-31T23:59:59.123Z
+    #define EPOCH_NS_TIMESTAMP_FORMAT       "%epoch_ns"     // Nanoseconds since epoch
     #define DEFAULT_DELIMITER_TYPE          enumDelimiterType::TAB
     #define DEFAULT_PADDING_SIZE            enumPaddingSize::ZERO
     #define DEFAULT_LOG_EXTENSION           ".log"
+
+    // Size of the inline buffer of log records. Longer messages continue in heap memory.
+    #define DEFAULT_RECORD_BUFFER_SIZE      256
+
+    // Heap strings of finished records are kept per thread and reused by the following records
+    #define DEFAULT_RECORD_POOL_SIZE        4
+
+    // Messages longer than the maximum size are truncated and end with the marker. Zero disables truncation.
+    #define DEFAULT_MAX_MESSAGE_SIZE        0
+    #define DEFAULT_TRUNCATION_MARKER       "...[truncated]"
+
+    // Define default settings of log file buffering
+    #define DEFAULT_FILE_BUFFER_SIZE        65536
+    #define DEFAULT_FLUSH_POLICY            enumFlushPolicy::ALWAYS
+    #define DEFAULT_FLUSH_THRESHOLD         0
+    #define DEFAULT_FILE_SEGMENT_SIZE       (16 * 1024 * 1024)
+
+    // Define default settings of batched writes. A batch of one record writes every message immediately.
+    #define DEFAULT_CONSOLE_BUFFER_SIZE     65536
+    #define DEFAULT_BATCH_MAX_RECORDS       1
+    #define DEFAULT_BATCH_MAX_LATENCY_US    1000
+
+    // Console output that is not a terminal is block-buffered, and pending lines are written at most this long after the first one
+    #define DEFAULT_CONSOLE_FLUSH_INTERVAL_MS   100
+
+    // Rotated log files are renamed to "<name>.<suffix><extension>" (e.g. app.20240131-235959-123.log)
+    #define DEFAULT_ROTATION_SUFFIX_FORMAT  "%Y%m%d-%H%M%S-%f"
+
+    // Define default settings of duplicate message suppression
+    #define DEFAULT_DUPLICATE_INTERVAL_MS   10000
+    #define DEFAULT_DUPLICATE_SLOT_COUNT    1024
+
+    // Define default settings of asynchronous logging
+    #define DEFAULT_ASYNC_QUEUE_CAPACITY    8192
+    #define DEFAULT_ASYNC_OVERFLOW_POLICY   enumOverflowPolicy::BLOCK
+    #define DEFAULT_ASYNC_IDLE_SLEEP_US     200
+
+    // Interval of checking the configuration file for changes on platforms without file notifications
+    #define DEFAULT_CONFIG_POLL_MS          1000
+
+    // Longest time in milliseconds pending messages are drained at exit and after a fatal message
+    #define DEFAULT_DRAIN_TIMEOUT_MS        2000
+
+    // Longest time in milliseconds a crashing thread waits for the asynchronous writer. It is short, since the writer allocates
+    // while formatting and never finishes if the crash happened inside the allocator.
+    #define DEFAULT_CRASH_DRAIN_TIMEOUT_MS  100
 }
 
 #endif // LOGGER_FORMAT_H
\ No newline at end of file
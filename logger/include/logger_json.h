@@ -0,0 +1,22 @@
+#ifndef LOGGER_JSON_H
+#define LOGGER_JSON_H
+
+#include <string>
+#include <string_view>
+
+namespace logger{
+
+    /**
+     * @brief This function appends the string as a quoted JSON string.
+     *
+     * Quote, backslash and control characters are escaped. The input is scanned 16 bytes at a time with SSE2
+     * where available, so runs of plain characters are copied in bulk. Other bytes, including UTF-8 sequences,
+     * are copied as they are.
+     *
+     * @param[in] out Output string. Quoted string is appended.
+     * @param[in] s Input string
+    */
+    void append_json_string(std::string &out, std::string_view s);
+}
+
+#endif  // LOGGER_JSON_H
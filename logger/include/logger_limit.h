@@ -0,0 +1,146 @@
+#ifndef LOGGER_LIMIT_H
+#define LOGGER_LIMIT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "logger_stats.h"
+
+namespace logger{
+
+    /**
+     * @class CallSiteLimiter
+     *
+     * @brief Base class of the state kept by a rate limited or sampled log call site.
+     *
+     * It counts calls that are suppressed since the last emitted message, so the next emitted message can report them.
+     *
+    */
+    class CallSiteLimiter{
+    protected:
+        std::atomic<uint64_t> suppressed_{0};
+
+        /**
+         * @brief This function counts a suppressed call.
+         *
+         * @return Always false, so it can be returned by should_log of derived classes
+        */
+        bool suppress_() noexcept{
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            LogStats::add_suppressed();
+            return false;
+        }
+
+    public:
+        /**
+         * @brief This function returns number of suppressed calls since the last call and resets it.
+         *
+         * @return Number of suppressed calls
+        */
+        uint64_t take_suppressed() noexcept{
+            // Plain load first, so the common case without suppressed calls does not write the shared counter
+            if (suppressed_.load(std::memory_order_relaxed) == 0) return 0;
+            return suppressed_.exchange(0, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @class EveryNLimiter
+     *
+     * @brief This class lets through the first call and then one of every n calls of the call site.
+     *
+    */
+    class EveryNLimiter: public CallSiteLimiter{
+    private:
+        std::atomic<uint64_t> counter_{0};
+
+    public:
+        /**
+         * @brief This function checks whether the call is logged.
+         *
+         * @param[in] n Period of logged calls. Values less than two log every call.
+         *
+         * @return True if the call is logged
+        */
+        bool should_log(uint64_t n) noexcept{
+            uint64_t count = counter_.fetch_add(1, std::memory_order_relaxed);
+            if (n <= 1 || count % n == 0) return true;
+            return suppress_();
+        }
+    };
+
+    /**
+     * @class RateLimiter
+     *
+     * @brief This class lets through at most the given number of calls of the call site per second.
+     *
+     * Calls are counted in fixed one-second windows. The window is restarted by the first call after it ends.
+     *
+    */
+    class RateLimiter: public CallSiteLimiter{
+    private:
+        std::atomic<int64_t> window_start_ns_{INT64_MIN};
+        std::atomic<uint64_t> window_count_{0};
+
+    public:
+        /**
+         * @brief This function checks whether the call is logged.
+         *
+         * @param[in] per_second Number of calls logged per second
+         *
+         * @return True if the call is logged
+        */
+        bool should_log(uint64_t per_second) noexcept{
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            int64_t start = window_start_ns_.load(std::memory_order_relaxed);
+            if (start == INT64_MIN || now - start >= 1000000000){
+                // Only the thread that moves the window resets the count
+                if (window_start_ns_.compare_exchange_strong(start, now, std::memory_order_relaxed)){
+                    window_count_.store(0, std::memory_order_relaxed);
+                }
+            }
+            if (window_count_.fetch_add(1, std::memory_order_relaxed) < per_second) return true;
+            return suppress_();
+        }
+    };
+
+    /**
+     * @class SampleLimiter
+     *
+     * @brief This class lets through each call of the call site with the given probability.
+     *
+     * Random numbers are drawn from a per-thread xorshift generator, so sampling takes no lock and no system call.
+     *
+    */
+    class SampleLimiter: public CallSiteLimiter{
+    private:
+        static uint64_t next_random_() noexcept{
+            thread_local uint64_t state = 0;
+            if (state == 0){
+                state = (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count() ^ (uint64_t) (uintptr_t) &state;
+                if (state == 0) state = 0x9E3779B97F4A7C15ULL;
+            }
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+
+    public:
+        /**
+         * @brief This function checks whether the call is logged.
+         *
+         * @param[in] probability Probability of logging the call in range [0, 1]
+         *
+         * @return True if the call is logged
+        */
+        bool should_log(double probability) noexcept{
+            if (probability >= 1.0) return true;
+            if (probability > 0.0 && (double) (next_random_() >> 11) < probability * 9007199254740992.0) return true;
+            return suppress_();
+        }
+    };
+}
+
+#endif  // LOGGER_LIMIT_H
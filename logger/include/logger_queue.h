@@ -0,0 +1,138 @@
+#ifndef LOGGER_QUEUE_H
+#define LOGGER_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace logger{
+
+    // Size of a cache line. Producer and consumer cursors are kept apart to avoid false sharing.
+    #define LOGGER_CACHE_LINE_SIZE 64
+
+    /**
+     * @class SpscRingBuffer
+     *
+     * @brief Bounded wait-free ring buffer for a single producer and a single consumer.
+     *
+     * Each side owns one cursor and keeps a cached copy of the other side's cursor, so the shared cache
+     * lines are only read when the cached view says the buffer is full or empty. Neither side ever
+     * retries, so pushing and popping complete in a bounded number of steps. Capacity is rounded up to
+     * the next power of two.
+     *
+    */
+    template<typename T>
+    class SpscRingBuffer{
+    private:
+        std::unique_ptr<T[]> slots_;
+        std::size_t mask_;
+
+        alignas(LOGGER_CACHE_LINE_SIZE) std::atomic<std::size_t> tail_;     // Written by the producer
+        std::size_t head_cache_;                                            // Producer's view of head_
+        alignas(LOGGER_CACHE_LINE_SIZE) std::atomic<std::size_t> head_;     // Written by the consumer
+        std::size_t tail_cache_;                                            // Consumer's view of tail_
+
+        static std::size_t round_up_pow2_(std::size_t n){
+            std::size_t result = 2;
+            while (result < n) result <<= 1;
+            return result;
+        }
+
+    public:
+        /**
+         * @brief Constructor of the ring buffer.
+         *
+         * @param[in] capacity Minimum number of records the buffer can hold. Rounded up to the next power of two.
+         *
+        */
+        explicit SpscRingBuffer(std::size_t capacity):
+            slots_(new T[round_up_pow2_(capacity)]),
+            mask_(round_up_pow2_(capacity) - 1),
+            tail_(0),
+            head_cache_(0),
+            head_(0),
+            tail_cache_(0){
+        }
+
+        SpscRingBuffer(const SpscRingBuffer &obj) = delete;
+        void operator=(const SpscRingBuffer &obj) = delete;
+
+        /**
+         * @brief This function copies an item into the buffer. It must only be called from the producer thread.
+         *
+         * Slots are constructed once and never destroyed by popping, so copy assignment reuses the storage
+         * of the item previously stored in the slot.
+         *
+         * @param[in] item Item to be copied into the buffer
+         *
+         * @return True if the item is stored, false if the buffer is full
+         *
+        */
+        bool try_push(const T &item){
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_cache_ > mask_){
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail - head_cache_ > mask_) return false;
+            }
+            slots_[tail & mask_] = item;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief This function returns the oldest item without removing it. It must only be called from the consumer thread.
+         *
+         * @return Pointer to the item, or nullptr if the buffer is empty. It is valid until pop is called.
+         *
+        */
+        T *front(){
+            std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_){
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_) return nullptr;
+            }
+            return &slots_[head & mask_];
+        }
+
+        /**
+         * @brief This function removes the oldest item. It must only follow a successful call of front.
+         *
+        */
+        void pop(){
+            head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief This function returns number of slots of the buffer.
+         *
+         * @return Capacity of the buffer
+         *
+        */
+        std::size_t capacity() const noexcept{
+            return mask_ + 1;
+        }
+
+        /**
+         * @brief This function returns whether the consumer has popped all pushed items. It can be called from either thread.
+         *
+         * @return True if the buffer is empty. Called from the producer, true also means the consumer is done with all its items.
+        */
+        bool empty() const noexcept{
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief This function returns approximate number of items waiting in the buffer.
+         *
+         * @return Number of items. The value may be stale while the producer is active.
+         *
+        */
+        std::size_t size_approx() const noexcept{
+            std::size_t head = head_.load(std::memory_order_relaxed);
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            return (tail > head)? tail - head: 0;
+        }
+    };
+}
+
+#endif  // LOGGER_QUEUE_H
@@ -0,0 +1,528 @@
+#ifndef LOGGER_RECORD_H
+#define LOGGER_RECORD_H
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <type_traits>
+
+#include "logger_defs.h"
+#include "logger_format.h"
+#include "logger_category.h"
+
+namespace logger{
+
+    /**
+     * @brief This function counts "{}" placeholders of the format string. It is evaluated at compile time by formatted log macros.
+     *
+     * "{{" and "}}" are literal braces and are not counted.
+     *
+     * @param[in] fmt Format string
+     *
+     * @return Number of placeholders. If the format string has an unmatched brace, returns -1.
+    */
+    constexpr int count_placeholders(const char *fmt){
+        int count = 0;
+        for (std::size_t i=0; fmt[i] != '\0'; i++){
+            if (fmt[i] == '{'){
+                if (fmt[i+1] == '{' || fmt[i+1] == '}') i++;
+                else return -1;
+                if (fmt[i] == '}') count++;
+            }
+            else if (fmt[i] == '}'){
+                if (fmt[i+1] == '}') i++;
+                else return -1;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief This function returns the file name of the path without its directories. It is evaluated at compile time by log macros.
+     *
+     * @param[in] path Path of the file (e.g. __FILE__)
+     *
+     * @return Pointer to the file name in the path
+    */
+    constexpr const char *source_basename(const char *path){
+        const char *base = path;
+        for (const char *p = path; *p != '\0'; p++){
+            if (*p == '/' || *p == '\\') base = p + 1;
+        }
+        return base;
+    }
+
+    /**
+     * @struct structSourceText
+     *
+     * @brief This struct renders the source field "basename:line" of a call site at compile time.
+     *
+     * @tparam N Size of the path including the null terminator. It bounds the length of the basename.
+    */
+    template<std::size_t N>
+    struct structSourceText{
+        char data[N + 12] = {};     ///< Rendered text. Line number takes at most 10 digits and the colon.
+        uint32_t size = 0;          ///< Length of the rendered text
+
+        constexpr structSourceText(const char *path, int line){
+            for (const char *p = source_basename(path); *p != '\0'; p++) data[size++] = *p;
+            data[size++] = ':';
+            char digits[10] = {};
+            int count = 0;
+            uint32_t value = (line > 0)? (uint32_t) line: 0;
+            do{
+                digits[count++] = (char) ('0' + value % 10);
+                value /= 10;
+            } while (value > 0);
+            while (count > 0) data[size++] = digits[--count];
+        }
+    };
+
+    /**
+     * @brief This function calls the function for each structured field packed into the fields of a log message.
+     *
+     * Each field is packed as kind, key length, key, value length and value.
+     *
+     * @param[in] fields Packed fields
+     * @param[in] f Function with (enumFieldKind kind, std::string_view key, std::string_view value) parameters
+    */
+    template<typename F>
+    void for_each_field(std::string_view fields, F &&f){
+        std::size_t pos = 0;
+        while (pos + 1 + 2 * sizeof(uint32_t) <= fields.size()){
+            enumFieldKind kind = (enumFieldKind) fields[pos++];
+            uint32_t key_len, value_len;
+            std::memcpy(&key_len, fields.data() + pos, sizeof(key_len));
+            pos += sizeof(key_len);
+            std::string_view key = fields.substr(pos, key_len);
+            pos += key_len;
+            std::memcpy(&value_len, fields.data() + pos, sizeof(value_len));
+            pos += sizeof(value_len);
+            std::string_view value = fields.substr(pos, value_len);
+            pos += value_len;
+            f(kind, key, value);
+        }
+    }
+
+    /**
+     * @class LogRecord
+     *
+     * @brief This class collects the parts of a single log message and emits it once when it is destroyed.
+     *
+     * It is created by log macros as a temporary, so "LogInfo << a << b" builds one record and emits it at the end of the statement.
+     * Parts are written into an inline stack buffer, and numbers are formatted with std::to_chars without allocating.
+     * If the buffer is exceeded, the message continues in a heap string.
+     *
+    */
+    class LogRecord{
+    private:
+        enumLogLevel log_level_;
+        const structSourceLocation *location_;
+        std::string_view category_;
+        const structLogSettings *settings_;
+        bool is_active_;
+        bool is_overflowed_;
+        bool is_truncated_;
+        uint64_t suppressed_count_;
+        std::size_t size_;
+        char buffer_[DEFAULT_RECORD_BUFFER_SIZE];
+        std::string overflow_;
+        std::string fields_;
+
+        static std::atomic<std::size_t> max_size_;
+
+        /**
+         * @brief This private function takes a string of a finished record of the thread, so its capacity is reused.
+         *
+         * @param[in] s String without heap storage. It is left unchanged if no string is kept.
+        */
+        static void acquire_string_(std::string &s) noexcept;
+
+        /**
+         * @brief This private function keeps the heap storage of the string for the following records of the thread.
+         *
+         * @param[in] s String to be released
+        */
+        static void release_string_(std::string &s) noexcept;
+
+        /**
+         * @brief This private function packs a structured field.
+         *
+         * @param[in] kind Kind of the value
+         * @param[in] key Key of the field
+         * @param[in] value Value as text
+         *
+         * @return Reference of the record
+        */
+        LogRecord &append_field_(enumFieldKind kind, std::string_view key, std::string_view value){
+            if (!is_active_) return *this;
+            if (fields_.empty()) acquire_string_(fields_);
+            uint32_t key_len = (uint32_t) key.size();
+            uint32_t value_len = (uint32_t) value.size();
+            fields_.push_back((char) kind);
+            fields_.append((const char*) &key_len, sizeof(key_len));
+            fields_.append(key.data(), key.size());
+            fields_.append((const char*) &value_len, sizeof(value_len));
+            fields_.append(value.data(), value.size());
+            return *this;
+        }
+
+        /**
+         * @brief This private function appends characters to the message.
+         *
+         * @param[in] data Characters to be appended
+         * @param[in] size Number of characters
+         *
+        */
+        void append_(const char *data, std::size_t size){
+            if (!is_overflowed_){
+                if (size_ + size <= sizeof(buffer_)){
+                    std::memcpy(buffer_ + size_, data, size);
+                    size_ += size;
+                    return;
+                }
+                // Move the message to heap string once the inline buffer is exceeded
+                acquire_string_(overflow_);
+                overflow_.reserve(2 * (size_ + size));
+                overflow_.assign(buffer_, size_);
+                is_overflowed_ = true;
+            }
+            std::size_t max_size = max_size_.load(std::memory_order_relaxed);
+            if (max_size > 0 && overflow_.size() + size > max_size){
+                size = (overflow_.size() < max_size)? max_size - overflow_.size(): 0;
+                is_truncated_ = true;
+            }
+            overflow_.append(data, size);
+        }
+
+        /**
+         * @brief This private function appends literal part of the format string until the next "{}" placeholder.
+         *
+         * @param[in] fmt Position in the format string
+         *
+         * @return Position after the placeholder, or the end of the format string
+        */
+        const char *format_literal_(const char *fmt){
+            const char *begin = fmt;
+            for (; *fmt != '\0'; fmt++){
+                if ((fmt[0] == '{' && fmt[1] == '{') || (fmt[0] == '}' && fmt[1] == '}')){
+                    // Write up to and including the first brace, then skip the second one
+                    append_(begin, (std::size_t) (fmt - begin) + 1);
+                    begin = ++fmt + 1;
+                }
+                else if (fmt[0] == '{' && fmt[1] == '}'){
+                    append_(begin, (std::size_t) (fmt - begin));
+                    return fmt + 2;
+                }
+            }
+            append_(begin, (std::size_t) (fmt - begin));
+            return fmt;
+        }
+
+        friend class Logger;
+
+    public:
+        /**
+         * @brief Constructor of the class.
+         *
+         * @param[in] level Log level of the message
+         * @param[in] location Call site of the record. It must outlive the logger (e.g. LOGGER_SOURCE_LOCATION_()).
+         * @param[in] settings Settings read by the log call. If null, the record discards its parts and emits nothing.
+         *
+        */
+        LogRecord(enumLogLevel level, const structSourceLocation *location, const structLogSettings *settings) noexcept:
+            log_level_(level), location_(location), settings_(settings), is_active_(settings != nullptr), is_overflowed_(false), is_truncated_(false),
+            suppressed_count_(0), size_(0){
+        }
+
+        /**
+         * @brief Constructor of the class. The message is written with the name of the category.
+         *
+         * @param[in] level Log level of the message
+         * @param[in] location Call site of the record. It must outlive the logger (e.g. LOGGER_SOURCE_LOCATION_()).
+         * @param[in] category Category of the message
+         * @param[in] settings Settings read by the log call. If null, the record discards its parts and emits nothing.
+         *
+        */
+        LogRecord(enumLogLevel level, const structSourceLocation *location, const LogCategory &category, const structLogSettings *settings) noexcept:
+            LogRecord(level, location, settings){
+            category_ = category.name();
+        }
+
+        /**
+         * @brief Move constructor. Moved-from record emits nothing.
+        */
+        LogRecord(LogRecord &&other) noexcept:
+            log_level_(other.log_level_), location_(other.location_), category_(other.category_), settings_(other.settings_),
+            is_active_(other.is_active_), is_overflowed_(other.is_overflowed_), is_truncated_(other.is_truncated_), suppressed_count_(other.suppressed_count_), size_(other.size_),
+            overflow_(std::move(other.overflow_)), fields_(std::move(other.fields_)){
+            if (!is_overflowed_) std::memcpy(buffer_, other.buffer_, size_);
+            other.is_active_ = false;
+        }
+
+        LogRecord(const LogRecord &obj) = delete;
+        void operator=(const LogRecord &obj) = delete;
+        void operator=(LogRecord &&obj) = delete;
+
+        /**
+         * @brief Destructor of the class. Emits the collected message.
+        */
+        ~LogRecord();
+
+        /**
+         * @brief This function appends string to the message.
+         *
+         * @param[in] s Input string
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(std::string_view s){
+            if (is_active_) append_(s.data(), s.size());
+            return *this;
+        }
+
+        /**
+         * @brief This function appends string to the message.
+         *
+         * @param[in] s Input string
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(const std::string &s){
+            return *this << std::string_view(s);
+        }
+
+        /**
+         * @brief This function appends string to the message. If it is the first part of the message, the string is taken without copying.
+         *
+         * @param[in] s Input string
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(std::string &&s){
+            if (!is_active_) return *this;
+            std::size_t max_size = max_size_.load(std::memory_order_relaxed);
+            if (size_ == 0 && !is_overflowed_ && (max_size == 0 || s.size() <= max_size)){
+                overflow_ = std::move(s);
+                is_overflowed_ = true;
+                return *this;
+            }
+            return *this << std::string_view(s);
+        }
+
+        /**
+         * @brief This function appends null terminated string to the message.
+         *
+         * @param[in] s Input string
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(const char *s){
+            return *this << ((s != nullptr)? std::string_view(s): std::string_view("(null)"));
+        }
+
+        /**
+         * @brief This function appends null terminated string to the message.
+         *
+         * @param[in] s Input string
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(char *s){
+            return *this << (const char*) s;
+        }
+
+        /**
+         * @brief This function appends character to the message.
+         *
+         * @param[in] c Input character
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(char c){
+            if (is_active_) append_(&c, 1);
+            return *this;
+        }
+
+        /**
+         * @brief This function appends boolean as "true" or "false" to the message.
+         *
+         * @param[in] b Input boolean
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(bool b){
+            return *this << (b? std::string_view("true"): std::string_view("false"));
+        }
+
+        /**
+         * @brief This function appends pointer address in hexadecimal to the message.
+         *
+         * @param[in] p Input pointer
+         *
+         * @return Reference of the record
+        */
+        LogRecord &operator<<(const void *p){
+            if (!is_active_) return *this;
+            char num[2 + 2 * sizeof(void*)] = {'0', 'x'};
+            auto r = std::to_chars(num + 2, num + sizeof(num), (uintptr_t) p, 16);
+            append_(num, (std::size_t) (r.ptr - num));
+            return *this;
+        }
+
+        /**
+         * @brief This function appends integer or floating point number to the message.
+         *
+         * @param[in] value Input number
+         *
+         * @return Reference of the record
+        */
+        template<typename T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value, int>::type = 0>
+        LogRecord &operator<<(T value){
+            if (!is_active_) return *this;
+            char num[64];
+            auto r = std::to_chars(num, num + sizeof(num), value);
+            append_(num, (std::size_t) (r.ptr - num));
+            return *this;
+        }
+
+        /**
+         * @brief This function appends arguments to the message by substituting "{}" placeholders of the format string.
+         *
+         * Arguments are written directly into the record with the same rules as operator<<.
+         * "{{" and "}}" are written as literal braces. LogXxxF macros check the format string at compile time.
+         *
+         * @param[in] fmt Format string
+         * @param[in] args Arguments to be formatted
+         *
+         * @return Reference of the record
+        */
+        template<typename... Args>
+        LogRecord &format(const char *fmt, const Args&... args){
+            if (!is_active_) return *this;
+            ((fmt = format_literal_(fmt), *this << args), ...);
+            format_literal_(fmt);
+            return *this;
+        }
+
+        /**
+         * @brief This function attaches a structured field with string value to the record (e.g. LogInfo.kv("user", name) << "Login").
+         *
+         * Text lines show fields as key=value after the message, and JSON lines as members of the object.
+         *
+         * @param[in] key Key of the field
+         * @param[in] value Value of the field
+         *
+         * @return Reference of the record
+        */
+        LogRecord &kv(std::string_view key, std::string_view value){
+            return append_field_(enumFieldKind::STRING, key, value);
+        }
+
+        /**
+         * @brief This function attaches a structured field with string value to the record.
+         *
+         * @param[in] key Key of the field
+         * @param[in] value Value of the field
+         *
+         * @return Reference of the record
+        */
+        LogRecord &kv(std::string_view key, const std::string &value){
+            return kv(key, std::string_view(value));
+        }
+
+        /**
+         * @brief This function attaches a structured field with null terminated string value to the record.
+         *
+         * @param[in] key Key of the field
+         * @param[in] value Value of the field
+         *
+         * @return Reference of the record
+        */
+        LogRecord &kv(std::string_view key, const char *value){
+            return kv(key, (value != nullptr)? std::string_view(value): std::string_view("(null)"));
+        }
+
+        /**
+         * @brief This function attaches a structured field with boolean value to the record.
+         *
+         * @param[in] key Key of the field
+         * @param[in] value Value of the field
+         *
+         * @return Reference of the record
+        */
+        LogRecord &kv(std::string_view key, bool value){
+            return append_field_(enumFieldKind::LITERAL, key, value? std::string_view("true"): std::string_view("false"));
+        }
+
+        /**
+         * @brief This function attaches a structured field with character value to the record.
+         *
+         * @param[in] key Key of the field
+         * @param[in] value Value of the field
+         *
+         * @return Reference of the record
+        */
+        LogRecord &kv(std::string_view key, char value){
+            return append_field_(enumFieldKind::STRING, key, std::string_view(&value, 1));
+        }
+
+        /**
+         * @brief This function attaches a structured field with numeric value to the record. Numbers are formatted with std::to_chars.
+         *
+         * @param[in] key Key of the field
+         * @param[in] value Value of the field. Infinite and NaN values are written as strings, since JSON has no literal for them.
+         *
+         * @return Reference of the record
+        */
+        template<typename T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value, int>::type = 0>
+        LogRecord &kv(std::string_view key, T value){
+            if (!is_active_) return *this;
+            char num[64];
+            auto r = std::to_chars(num, num + sizeof(num), value);
+            enumFieldKind kind = enumFieldKind::LITERAL;
+            if constexpr (std::is_floating_point<T>::value){
+                if (!std::isfinite(value)) kind = enumFieldKind::STRING;
+            }
+            return append_field_(kind, key, std::string_view(num, (std::size_t) (r.ptr - num)));
+        }
+
+        /**
+         * @brief This function sets number of calls of the call site that are suppressed before this record.
+         *
+         * If it is not zero, the summary is appended to the message when the record is emitted.
+         *
+         * @param[in] count Number of suppressed calls
+         *
+         * @return Reference of the record
+        */
+        LogRecord &set_suppressed_count(uint64_t count) noexcept{
+            suppressed_count_ = count;
+            return *this;
+        }
+
+        /**
+         * @brief This function returns whether the record will be emitted.
+         *
+         * @return True if the record is active
+        */
+        bool is_active() const noexcept{
+            return is_active_;
+        }
+
+        /**
+         * @brief This function returns the message collected so far.
+         *
+         * @return Message
+        */
+        std::string_view message() const noexcept{
+            return is_overflowed_? std::string_view(overflow_): std::string_view(buffer_, size_);
+        }
+    };
+}
+
+#endif  // LOGGER_RECORD_H
@@ -0,0 +1,555 @@
+#ifndef LOGGER_SINK_H
+#define LOGGER_SINK_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "logger_defs.h"
+#include "logger_format.h"
+#include "logger_file.h"
+#include "logger_timestamp.h"
+
+namespace logger{
+
+    /**
+     * @class LineFormatter
+     *
+     * @brief This class formats log messages as text lines with a compiled log format.
+     *
+     * Formatters are created once per distinct format by the Logger and live until the application exits,
+     * so sinks that share a format share the formatter, and a message is formatted once for all of them.
+     *
+    */
+    class LineFormatter{
+    private:
+        structLogFormat fmt_;
+        TimestampFormatter timestamp_formatter_;
+        structLineLayout layout_;
+
+        /**
+         * @brief This private function appends the log message as a JSON object in a single line.
+         *
+         * @param[in] msg_log Log message structure
+         * @param[in] out Output string. Log line is appended.
+        */
+        void format_json_(const structLogMsg &msg_log, std::string &out) const;
+
+    public:
+        /**
+         * @brief Constructor of the class.
+         *
+         * @param[in] fmt Log format
+         * @param[in] layout Line layout compiled from the log format
+        */
+        LineFormatter(const structLogFormat &fmt, const structLineLayout &layout);
+
+        LineFormatter(const LineFormatter &obj) = delete;
+        void operator=(const LineFormatter &obj) = delete;
+
+        /**
+         * @brief This function appends the log message as a text line, or as a JSON line if the output format is JSON.
+         *
+         * @param[in] msg_log Log message structure
+         * @param[in] out Output string. Log line is appended.
+        */
+        void format(const structLogMsg &msg_log, std::string &out) const;
+
+        /**
+         * @brief This function returns the log format of the formatter.
+         *
+         * @return Log format
+        */
+        const structLogFormat &get_format() const noexcept;
+    };
+
+    /**
+     * @class LogSink
+     *
+     * @brief This class is the interface of log outputs.
+     *
+     * The Logger fans every message out to its sinks. Each sink has its own least severe level and optionally its own
+     * format. Messages are formatted by the Logger once per distinct format and handed to the sinks as text lines.
+     *
+    */
+    class LogSink{
+    private:
+        std::atomic<int> level_;
+        std::atomic<const LineFormatter*> formatter_;
+        std::atomic<uint64_t> bytes_written_;
+
+        static std::atomic<uint32_t> batch_max_records_;
+        static std::atomic<uint64_t> batch_max_latency_us_;
+
+    protected:
+        /**
+         * @brief This function counts a record written to the sink and checks whether the batch is complete.
+         *
+         * Mutex of the sink must be held by the caller.
+         *
+         * @param[in] batch Batch state of the sink
+         *
+         * @return True if the batch reached the maximum number of records or its latency bound
+        */
+        static bool add_to_batch_(structOutputBatch &batch);
+
+        /**
+         * @brief This function checks whether pending records of the batch should be written.
+         *
+         * @param[in] batch Batch state of the sink
+         * @param[in] force If true, any pending record makes the batch due.
+         *
+         * @return True if the batch should be written
+        */
+        static bool is_batch_due_(const structOutputBatch &batch, bool force);
+
+        /**
+         * @brief This function counts bytes written by the sink. Mutex of the sink must be held by the caller.
+         *
+         * @param[in] size Number of bytes
+        */
+        void add_bytes_written_(uint64_t size) noexcept{
+            bytes_written_.store(bytes_written_.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+        }
+
+    public:
+        /**
+         * @brief Constructor of the class. The sink accepts all levels and uses the format of the Logger.
+        */
+        LogSink();
+
+        /**
+         * @brief Destructor of the class.
+        */
+        virtual ~LogSink() = default;
+
+        LogSink(const LogSink &obj) = delete;
+        void operator=(const LogSink &obj) = delete;
+
+        /**
+         * @brief This function writes the formatted log line. It can be called from multiple threads.
+         *
+         * @param[in] msg_log Log message structure
+         * @param[in] line Log line formatted with the format of the sink
+        */
+        virtual void write(const structLogMsg &msg_log, const std::string &line) = 0;
+
+        /**
+         * @brief This function writes all buffered content of the sink.
+        */
+        virtual void flush(){}
+
+        /**
+         * @brief This function writes buffered content of the sink from a signal handler after a crash.
+         *
+         * It must only call async-signal-safe functions and must not take locks.
+        */
+        virtual void flush_on_crash() noexcept{}
+
+        /**
+         * @brief This function writes records gathered in the current batch.
+         *
+         * @param[in] force If false, only a batch past its latency bound or a time-based flush that is due is written.
+        */
+        virtual void commit(bool force){ (void) force; }
+
+        /**
+         * @brief This function releases resources of the sink when it is removed from the Logger. By default, it flushes the sink.
+        */
+        virtual void close(){ flush(); }
+
+        /**
+         * @brief This function returns number of bytes written by the sink.
+         *
+         * @return Number of bytes, including bytes still in the buffer of the sink
+        */
+        uint64_t get_bytes_written() const noexcept{
+            return bytes_written_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief This function sets least severe level of the sink.
+         *
+         * @param[in] level Least severe log level to be written (e.g. enumLogLevel::ERROR_ writes ERROR and FATAL only).
+        */
+        void set_level(enumLogLevel level) noexcept;
+
+        /**
+         * @brief This function returns least severe level of the sink.
+         *
+         * @return Least severe log level to be written
+        */
+        enumLogLevel get_level() const noexcept;
+
+        /**
+         * @brief This function checks whether messages of the log level are written by the sink.
+         *
+         * @param[in] level Log level of message
+         *
+         * @return True if messages of the level are written
+        */
+        inline bool should_log(enumLogLevel level) const noexcept{
+            return (int) level <= level_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief This function sets format of the sink. It can be changed while logging.
+         *
+         * @param[in] fmt Format to be applied
+        */
+        void set_format(const structLogFormat &fmt);
+
+        /**
+         * @brief This function makes the sink use the format of the Logger again.
+        */
+        void reset_format() noexcept;
+
+        /**
+         * @brief This function returns formatter of the sink.
+         *
+         * @return Formatter of the sink. nullptr if the sink uses the format of the Logger.
+        */
+        inline const LineFormatter *get_formatter() const noexcept{
+            return formatter_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief This function sets how many records sinks gather before they are written. It applies to all sinks.
+         *
+         * @param[in] max_records Maximum number of records per batch. One writes every record immediately.
+         * @param[in] max_latency_us Maximum time in microseconds a record waits in the batch. Zero disables the bound.
+        */
+        static void set_batch_policy(uint32_t max_records, uint64_t max_latency_us) noexcept;
+
+        /**
+         * @brief This function returns maximum number of records per batch.
+         *
+         * @return Maximum number of records
+        */
+        static uint32_t get_batch_max_records() noexcept;
+
+        /**
+         * @brief This function returns maximum time a record waits in the batch.
+         *
+         * @return Latency bound in microseconds
+        */
+        static uint64_t get_batch_max_latency_us() noexcept;
+    };
+
+    /**
+     * @class ConsoleSink
+     *
+     * @brief This class writes log lines to the standard output, optionally colored by log level.
+     *
+     * If the output is a terminal, lines are written as they are logged. Otherwise (e.g. a pipe of a log collector), output is
+     * block-buffered and colors are not written. Lines at or above the stderr level can be routed to the standard error.
+     *
+    */
+    class ConsoleSink: public LogSink{
+    private:
+        LogFile file_;
+        LogFile err_file_;
+        std::mutex mutex_;
+        std::atomic<int> colors_;
+        std::atomic<bool> is_block_buffered_;
+        std::atomic<int> stderr_level_;
+        bool is_tty_;
+        bool is_err_tty_;
+        bool is_idle_flush_started_;
+        structOutputBatch batch_;
+
+        /**
+         * @brief This private function writes pending records with a single write. Mutex must be held by the caller.
+        */
+        void flush_();
+
+        /**
+         * @brief This private function appends the line to the buffer of the stream. Mutex must be held by the caller.
+         *
+         * @param[in] file Stream of the line
+         * @param[in] is_tty Whether the stream is a terminal. Colors are written only to terminals.
+         * @param[in] msg_log Log message structure
+         * @param[in] line Formatted log line
+        */
+        void append_line_(LogFile &file, bool is_tty, const structLogMsg &msg_log, const std::string &line);
+
+    public:
+        /**
+         * @brief Constructor of the class. Writes to the standard output and the standard error.
+        */
+        ConsoleSink();
+
+        /**
+         * @brief Constructor of the class. Writes to the given file descriptors, which are not closed by the sink.
+         *
+         * @param[in] out_fd File descriptor used as the standard output
+         * @param[in] err_fd File descriptor used as the standard error
+        */
+        ConsoleSink(int out_fd, int err_fd);
+
+        void write(const structLogMsg &msg_log, const std::string &line) override;
+        void flush() override;
+        void flush_on_crash() noexcept override;
+        void commit(bool force) override;
+
+        /**
+         * @brief This function enables or disables colors of log lines. Until it is called, the sink follows Logger::enable_colors.
+         *
+         * @param[in] is_enabled True to color log lines by log level
+        */
+        void set_colors(bool is_enabled) noexcept;
+
+        /**
+         * @brief This function overrides whether the output is block-buffered. By default, it is block-buffered if the output is not a terminal.
+         *
+         * Block-buffered output is written when the buffer is full, on ERROR and FATAL messages, on flush, and at most
+         * DEFAULT_CONSOLE_FLUSH_INTERVAL_MS after the first pending line. Otherwise, batches of set_batch_policy are used.
+         *
+         * @param[in] is_enabled True to buffer output in blocks
+        */
+        void set_block_buffered(bool is_enabled) noexcept;
+
+        /**
+         * @brief This function routes messages at or above the level to the standard error.
+         *
+         * @param[in] is_enabled True to route messages to the standard error
+         * @param[in] level Least severe level written to the standard error
+        */
+        void set_stderr_routing(bool is_enabled, enumLogLevel level=enumLogLevel::ERROR_) noexcept;
+
+        /**
+         * @brief This function returns whether the output is block-buffered.
+         *
+         * @return True if the output is block-buffered
+        */
+        bool is_block_buffered() const noexcept;
+
+        /**
+         * @brief This function returns whether the output is a terminal.
+         *
+         * @return True if the output is a terminal
+        */
+        bool is_tty() const noexcept;
+    };
+
+    /**
+     * @class FileSink
+     *
+     * @brief This class writes log lines to a buffered log file with optional rotation.
+     *
+    */
+    class FileSink: public LogSink{
+    private:
+        LogFile file_;
+        std::mutex mutex_;
+        std::string file_dir_;
+        std::string filename_;
+        std::string root_filename_;
+        bool timestamp_prefix_enabled_;
+
+        enumFlushPolicy flush_policy_;
+        uint64_t flush_threshold_;
+        std::chrono::steady_clock::time_point last_flush_time_;
+        structOutputBatch batch_;
+
+        structRotationPolicy rotation_policy_;
+        uint64_t rotation_max_file_size_;
+        int64_t next_rollover_ns_;
+
+        /**
+         * @brief This private function flushes the file if the flush policy requires it.
+         *
+         * With ALWAYS policy, the file is flushed once per batch of records. Mutex must be held by the caller.
+         *
+         * @param[in] log_level Log level of the last written message
+        */
+        void apply_flush_policy_(enumLogLevel log_level);
+
+        /**
+         * @brief This private function flushes the file. Mutex must be held by the caller.
+        */
+        void flush_();
+
+        /**
+         * @brief This private function sets timestamp prefix to the filename.
+         *
+         * @param[in] ts Timestamp struct
+         *
+         * @return Prefixed filename
+        */
+        std::string add_timestamp_prefix_(const structTimestamp &ts) const;
+
+        /**
+         * @brief This private function closes the file and continues in the next one.
+         *
+         * If the filename does not change, the current file is renamed with a timestamp suffix first.
+         * Rotated files beyond the limit are deleted later by the housekeeping thread. Mutex must be held by the caller.
+         *
+         * @param[in] ts Timestamp of the message that triggers the rotation
+        */
+        void rotate_(const structTimestamp &ts);
+
+        /**
+         * @brief This private function computes the next time-based rollover boundary.
+         *
+         * It is the earliest of the next rotation interval and, if timestamp prefix is enabled, the next local midnight.
+         *
+         * @param[in] now_ns Current time in nanoseconds since epoch
+         *
+         * @return Rollover boundary in nanoseconds since epoch. INT64_MAX if time-based rotation is disabled.
+        */
+        int64_t compute_next_rollover_(int64_t now_ns) const;
+
+        /**
+         * @brief This private function returns the filename a rotated file is renamed to.
+         *
+         * @param[in] ts Timestamp of the rotation
+         *
+         * @return Filename that does not exist in the log directory
+        */
+        std::string make_rotated_filename_(const structTimestamp &ts) const;
+
+        /**
+         * @brief This private function asks the housekeeping thread to delete rotated files beyond the limit.
+         *
+         * Mutex must be held by the caller.
+        */
+        void request_prune_() const;
+
+        /**
+         * @brief This private function checks whether the file is a rotated file of the log file.
+         *
+         * @param[in] filename Filename to be checked
+         * @param[in] root_filename Filename of the log file without timestamp prefix
+         *
+         * @return True if the file is a rotated file
+        */
+        static bool is_rotated_filename_(const std::string &filename, const std::string &root_filename);
+
+    public:
+        /**
+         * @brief Constructor of the class. The file is opened by open().
+         *
+         * @param[in] buffer_size Size of the user-space buffer in bytes
+        */
+        explicit FileSink(std::size_t buffer_size=DEFAULT_FILE_BUFFER_SIZE);
+
+        /**
+         * @brief This function opens the log file. Content of the existing file is discarded.
+         *
+         * @param[in] filename Filename of the log file. No need to define file extension. ".log" is default format.
+         * @param[in] file_dir Directory of the log file. Leave empty if home location is desired.
+         * @param[in] timestamp_prefix_enabled This flag adds date to the filename as prefix and changes the file at local midnight.
+         *
+         * @return True if the file is opened
+        */
+        bool open(const std::string &filename, const std::string &file_dir="", bool timestamp_prefix_enabled=false);
+
+        void write(const structLogMsg &msg_log, const std::string &line) override;
+        void flush() override;
+        void flush_on_crash() noexcept override;
+        void commit(bool force) override;
+
+        /**
+         * @brief This function writes buffered content and closes the log file. It can be opened again by open().
+        */
+        void close() override;
+
+        /**
+         * @brief This function returns path of the log file.
+         *
+         * @return Path of the log file. Empty if the file is not opened.
+        */
+        std::string get_path();
+
+        /**
+         * @brief This function sets when buffered content of the file is written to the disk.
+         *
+         * @param[in] policy Flush policy (enumFlushPolicy::ALWAYS, enumFlushPolicy::EVERY_N_BYTES, etc.)
+         * @param[in] threshold Number of bytes for EVERY_N_BYTES, number of milliseconds for EVERY_N_MS. Ignored for other policies.
+        */
+        void set_flush_policy(enumFlushPolicy policy, uint64_t threshold=DEFAULT_FLUSH_THRESHOLD);
+
+        /**
+         * @brief This function sets size of the buffer of the file.
+         *
+         * @param[in] size Buffer size in bytes. Zero disables buffering.
+        */
+        void set_buffer_size(std::size_t size);
+
+        /**
+         * @brief This function writes the file through memory-mapped segments instead of the buffer.
+         *
+         * @param[in] segment_size Segment size in bytes. Zero switches back to buffered writes.
+         *
+         * @return True on success
+        */
+        bool set_segment_size(std::size_t segment_size);
+
+        /**
+         * @brief This function sets when the file is rotated and how many rotated files are kept.
+         *
+         * @param[in] policy Rotation policy. Default policy disables rotation.
+        */
+        void set_rotation(const structRotationPolicy &policy);
+
+        /**
+         * @brief This function deletes the oldest rotated files beyond the limit. It is called by the housekeeping thread.
+         *
+         * @param[in] request Log files to be checked
+        */
+        static void prune_rotated_files(const structPruneRequest &request);
+    };
+
+    /**
+     * @class NullSink
+     *
+     * @brief This class discards log lines.
+     *
+    */
+    class NullSink: public LogSink{
+    public:
+        void write(const structLogMsg &msg_log, const std::string &line) override;
+    };
+
+    /**
+     * @class MemorySink
+     *
+     * @brief This class keeps log lines in memory.
+     *
+    */
+    class MemorySink: public LogSink{
+    private:
+        mutable std::mutex mutex_;
+        std::deque<std::string> lines_;
+        std::size_t capacity_;
+
+    public:
+        /**
+         * @brief Constructor of the class.
+         *
+         * @param[in] capacity Maximum number of kept lines. Oldest lines are discarded beyond it. Zero keeps all lines.
+        */
+        explicit MemorySink(std::size_t capacity=0);
+
+        void write(const structLogMsg &msg_log, const std::string &line) override;
+
+        /**
+         * @brief This function returns kept log lines, from the oldest to the newest.
+         *
+         * @return Log lines including line endings
+        */
+        std::vector<std::string> get_lines() const;
+
+        /**
+         * @brief This function discards kept log lines.
+        */
+        void clear();
+    };
+}
+
+#endif  // LOGGER_SINK_H
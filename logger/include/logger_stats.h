@@ -0,0 +1,130 @@
+#ifndef LOGGER_STATS_H
+#define LOGGER_STATS_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "logger_defs.h"
+
+namespace logger{
+
+    /**
+     * @struct structThreadCounters
+     *
+     * @brief This struct keeps the metrics counted on a single thread
+     *
+     * Only the owner thread writes the counters, so they are updated with plain loads and stores instead of
+     * atomic read-modify-write instructions. Readers aggregate the counters of all threads.
+     *
+    */
+    struct structThreadCounters{
+        std::atomic<uint64_t> level_counts[LOG_LEVEL_COUNT] = {};   ///< Logged messages per level
+        std::atomic<uint64_t> format_time_ns{0};                    ///< Estimated time spent formatting lines
+        std::atomic<uint64_t> suppressed_count{0};                  ///< Calls suppressed by limiters
+        std::atomic<uint64_t> duplicate_count{0};                   ///< Folded repeated messages
+        std::atomic<uint64_t> format_calls{0};                      ///< Number of formatted messages, used to pick sampled ones
+    };
+
+    /**
+     * @class LogStats
+     *
+     * @brief This class collects runtime metrics of the logger.
+     *
+     * Frequent events are counted in per-thread counters, and rare events (flushes, queue depth) in shared atomics.
+     * Counters of exited threads are kept in a total, so a snapshot covers the whole run.
+     *
+    */
+    class LogStats{
+    private:
+        static std::atomic<uint64_t> flush_count_;
+        static std::atomic<uint64_t> flush_latency_histogram_[LOGGER_FLUSH_HISTOGRAM_BUCKETS];
+        static std::atomic<uint64_t> queue_high_water_;
+
+        /**
+         * @brief This private function increments a counter owned by the calling thread.
+         *
+         * @param[in] counter Counter
+         * @param[in] value Value to be added
+        */
+        static void add_(std::atomic<uint64_t> &counter, uint64_t value) noexcept{
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+    public:
+        /**
+         * @brief This function returns the counters of the calling thread. They are registered on the first call of the thread.
+         *
+         * @return Counters of the thread
+        */
+        static structThreadCounters &local() noexcept;
+
+        /**
+         * @brief This function counts a logged message.
+         *
+         * @param[in] level Log level of the message
+        */
+        static void add_message(enumLogLevel level) noexcept{
+            add_(local().level_counts[(std::size_t) level < LOG_LEVEL_COUNT? (std::size_t) level: LOG_LEVEL_COUNT - 1], 1);
+        }
+
+        /**
+         * @brief This function counts a call suppressed by a rate limited or sampled macro.
+        */
+        static void add_suppressed() noexcept{
+            add_(local().suppressed_count, 1);
+        }
+
+        /**
+         * @brief This function counts a repeated message folded by duplicate suppression.
+        */
+        static void add_duplicate() noexcept{
+            add_(local().duplicate_count, 1);
+        }
+
+        /**
+         * @brief This function checks whether formatting of the next message is timed. One of every 16 messages is timed.
+         *
+         * @return True if the message is timed
+        */
+        static bool should_time_format() noexcept{
+            structThreadCounters &counters = local();
+            uint64_t calls = counters.format_calls.load(std::memory_order_relaxed);
+            counters.format_calls.store(calls + 1, std::memory_order_relaxed);
+            return calls % 16 == 0;
+        }
+
+        /**
+         * @brief This function adds the time of a timed formatting, scaled to the messages that are not timed.
+         *
+         * @param[in] ns Duration in nanoseconds
+        */
+        static void add_format_time(uint64_t ns) noexcept{
+            add_(local().format_time_ns, 16 * ns);
+        }
+
+        /**
+         * @brief This function counts a flush that wrote buffered content.
+         *
+         * @param[in] ns Duration of the flush in nanoseconds
+        */
+        static void add_flush(uint64_t ns) noexcept;
+
+        /**
+         * @brief This function updates the high-water mark of the asynchronous queue depth.
+         *
+         * @param[in] depth Number of messages waiting for the writer
+        */
+        static void update_queue_depth(uint64_t depth) noexcept;
+
+        /**
+         * @brief This function aggregates the counters of all threads.
+         *
+         * Counters are read without stopping the threads, so a snapshot taken during logging may be a few messages behind.
+         *
+         * @param[out] stats Snapshot. Only the fields collected by this class are filled.
+        */
+        static void collect(structLoggerStats &stats);
+    };
+}
+
+#endif  // LOGGER_STATS_H
@@ -0,0 +1,119 @@
+#ifndef LOGGER_TIMESTAMP_H
+#define LOGGER_TIMESTAMP_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "logger_defs.h"
+#include "logger_format.h"
+
+namespace logger{
+
+    /**
+     * @enum enumTimestampToken
+     *
+     * @brief This enum defines tokens of a compiled timestamp format
+    */
+    enum class enumTimestampToken: uint8_t{
+        LITERAL,
+        YEAR,           ///< %Y
+        MONTH,          ///< %m
+        DAY,            ///< %d
+        HOUR,           ///< %H
+        MINUTE,         ///< %M
+        SECOND,         ///< %S
+        MILLISECOND     ///< %f
+    };
+
+    /**
+     * @enum enumTimestampMode
+     *
+     * @brief This enum defines how a compiled timestamp format is rendered
+    */
+    enum class enumTimestampMode: uint8_t{
+        PATTERN,        ///< Tokens of the format string in local time
+        ISO8601_UTC,    ///< YYYY-MM-DDTHH:MM:SS.mmmZ in UTC
+        EPOCH_NS        ///< Nanoseconds since epoch
+    };
+
+    /**
+     * @struct structTimestampToken
+     *
+     * @brief This struct defines a token of a compiled timestamp format
+    */
+    struct structTimestampToken{
+        enumTimestampToken type;    ///< Token type
+        uint32_t offset;            ///< Offset of literal text in the literal pool
+        uint32_t size;              ///< Size of literal text
+    };
+
+    /**
+     * @class TimestampFormatter
+     *
+     * @brief This class renders timestamps with a format string that is parsed once.
+     *
+     * Rendered text of the current second is cached per thread, so consecutive timestamps
+     * within the same second only rewrite the millisecond digits.
+     *
+    */
+    class TimestampFormatter{
+    private:
+        enumTimestampMode mode_;
+        std::vector<structTimestampToken> tokens_;
+        std::string literals_;
+        uint64_t id_;
+
+        /**
+         * @brief This private function renders the timestamp without using the cache.
+         *
+         * @param[in] ts Timestamp structure
+         * @param[in] out Output string. Rendered text is appended.
+         * @param[out] msec_offsets Offsets of millisecond digits relative to the start of rendered text. Can be nullptr.
+         * @param[out] msec_count Number of millisecond fields. Can be nullptr.
+         *
+        */
+        void render_(const structTimestamp &ts, std::string &out, uint32_t *msec_offsets, uint32_t *msec_count) const;
+
+    public:
+        /**
+         * @brief Constructor of the class. Compiles the default timestamp format.
+        */
+        TimestampFormatter();
+
+        /**
+         * @brief Constructor of the class.
+         *
+         * @param[in] format Timestamp format (e.g. "%Y-%m-%d %H:%M:%S.%f", ISO8601_UTC_TIMESTAMP_FORMAT, EPOCH_NS_TIMESTAMP_FORMAT)
+        */
+        explicit TimestampFormatter(const std::string &format);
+
+        /**
+         * @brief This function parses the timestamp format. It must not be called while another thread is formatting.
+         *
+         * Supported placeholders are %Y, %m, %d, %H, %M, %S and %f. Unsupported placeholders are written as they are.
+         *
+         * @param[in] format Timestamp format
+        */
+        void compile(const std::string &format);
+
+        /**
+         * @brief This function renders the timestamp and appends it to the output string.
+         *
+         * @param[in] ts Timestamp structure
+         * @param[in] out Output string
+        */
+        void format(const structTimestamp &ts, std::string &out) const;
+
+        /**
+         * @brief This function renders the timestamp without touching the per-thread cache.
+         *
+         * @param[in] ts Timestamp structure
+         *
+         * @return Rendered timestamp
+        */
+        std::string format_uncached(const structTimestamp &ts) const;
+    };
+}
+
+#endif  // LOGGER_TIMESTAMP_H
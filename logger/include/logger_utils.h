@@ -21,8 +21,11 @@
 
 #include "logger_defs.h"
 #include "logger_format.h"
+#include "logger_timestamp.h"
 
 namespace logger{
+
+    inline static std::string get_home_dir();
     
     /**
      * @brief This function returns timestamp information with provided format
@@ -34,75 +37,31 @@ namespace logger{
      *  
     */
     static std::string format_time(const structTimestamp &ts, const std::string &format) {   
-        // Use a stringstream to build the formatted string
-        std::ostringstream formattedString;
-        size_t pos = 0;
-
-        while (pos < format.length()) {
-            // Find the next placeholder
-            size_t placeholderPos = format.find("%", pos);
-
-            // If no more placeholders are found, append the remaining text
-            if (placeholderPos == std::string::npos) {
-                formattedString << format.substr(pos);
-                break;
-            }
-
-            // Append text before the placeholder
-            formattedString << format.substr(pos, placeholderPos - pos);
-
-            // Handle the placeholder
-            char placeholder = format[placeholderPos + 1];
-            switch (placeholder) {
-                case 'Y':
-                    formattedString << std::setfill('0') << std::setw(4) << 1900 + ts.tm_year;
-                    break;
-                case 'm':
-                    formattedString << std::setfill('0') << std::setw(2) << ts.tm_mon;
-                    break;
-                case 'd':
-                    formattedString << std::setfill('0') << std::setw(2) << ts.tm_mday;
-                    break;
-                case 'H':
-                    formattedString << std::setfill('0') << std::setw(2) << ts.tm_hour;
-                    break;
-                case 'M':
-                    formattedString << std::setfill('0') << std::setw(2) << ts.tm_min;
-                    break;
-                case 'S':
-                    formattedString << std::setfill('0') << std::setw(2) << ts.tm_sec;
-                    break;
-                case 'f':
-                    formattedString << std::setfill('0') << std::setw(3) << ts.tm_msec;
-                    break;
-                default:
-                    // Handle unsupported placeholders or just include the placeholder character
-                    formattedString << "%" << placeholder;
-            }
-
-            // Move the position past the placeholder
-            pos = placeholderPos + 2;
-        }
-
-        return formattedString.str();
+        return TimestampFormatter(format).format_uncached(ts);
     }
     
     /**
-     * @brief This function returns current timetamp as struct.
+     * @brief This function converts time point of system clock to timestamp struct in local time.
      * 
-     * @param[in] ts Current timestamp struct
+     * @param[in] now Time point
+     * @param[in] ts Timestamp struct
      *  
     */        
-    inline void get_current_timestamp_struct(structTimestamp &ts){
-        auto now = std::chrono::system_clock::now();
+    inline void get_timestamp_struct(const std::chrono::system_clock::time_point &now, structTimestamp &ts){
+        // Local time is cached per thread, so it is computed once per second
+        thread_local std::time_t cached_time = -1;
+        thread_local struct tm timeInfo;
+
         std::time_t time = std::chrono::system_clock::to_time_t(now);
         auto tm_msec = static_cast<long int>((std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000).count());
-        struct tm timeInfo;
-        #ifdef PLATFORM_WINDOWS
-            localtime_s(&timeInfo, &time);
-        #else
-            localtime_r(&time, &timeInfo);
-        #endif
+        if (time != cached_time){
+            #ifdef PLATFORM_WINDOWS
+                localtime_s(&timeInfo, &time);
+            #else
+                localtime_r(&time, &timeInfo);
+            #endif
+            cached_time = time;
+        }
         
         ts = {tm_msec, 
               timeInfo.tm_sec,
@@ -113,7 +72,18 @@ namespace logger{
               timeInfo.tm_year,
               timeInfo.tm_wday,
               timeInfo.tm_yday,
-              timeInfo.tm_isdst};
+              timeInfo.tm_isdst,
+              std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()};
+    }
+
+    /**
+     * @brief This function returns current timetamp as struct.
+     * 
+     * @param[in] ts Current timestamp struct
+     *  
+    */        
+    inline void get_current_timestamp_struct(structTimestamp &ts){
+        get_timestamp_struct(std::chrono::system_clock::now(), ts);
     }
 
     /**
@@ -155,20 +125,23 @@ namespace logger{
     }
 
     /**
-     * @brief This function strips the left most delimiter from the message which is provided by log format.
+     * @brief This function normalizes directory path of log files.
      * 
-     * @param[in] msg Message
-     * @param[in] fmt Log format structure. If log format is not defined, uses default delimiter type.
+     * Home location is used if no directory is provided. Path separators are converted to "/" and a trailing "/" is appended.
+     * 
+     * @param[in] file_dir Directory path
      *
+     * @return Normalized directory path
+     *   
     */
-    static void lstrip_delimiter(std::string &msg, structLogFormat &fmt){
-        char delimiter;
-        if (fmt.fmt_delimiter_type!=enumDelimiterType::DEFAULT) delimiter = (char) fmt.fmt_delimiter_type;
-        else delimiter = (char) DEFAULT_DELIMITER_TYPE;
-
-        msg.erase(msg.begin(), std::find_if(msg.begin(), msg.end(), [delimiter](char c){
-            return (bool) (c!=delimiter);
-        }));
+    inline std::string normalize_dir(const std::string &file_dir){
+        // If the file directory is not provided, default log directory is home location
+        std::string out_dir = (file_dir=="")? get_home_dir(): std::string(file_dir);
+        // Append "/" to the end of directory path
+        if (out_dir.empty() || out_dir.back() != '/') out_dir.push_back('/');
+        // Convert all \ chars to / for cross-platfrom portatibility
+        std::replace(out_dir.begin(), out_dir.end(), '\\', '/');
+        return out_dir;
     }
 
     /**
@@ -225,37 +198,6 @@ namespace logger{
         msg += newline;
     }
 
-    /**
-     * @brief This function adds new field to the output string.
-     * 
-     * Field is a part of log message seperated from other fields by delimiters
-     * 
-     * @param[in] field New field to add
-     * @param[in] out Output string
-     * @param[in] fmt Log format structure
-     *
-    */
-    static void add_field(const std::string &field, std::string &out, structLogFormat &fmt){
-        if (field.size()<=0) return;
-
-        add_padding(out, fmt);
-        add_delimiter(out, fmt);
-        out += field;
-    }
-
-    /**
-     * @brief This function reads configuration file and updates log format structure.
-     * 
-     * @param[in] file_path File path of the configuration file 
-     * @param[in] fmt Log format structure
-     *
-    */
-    inline void read_config_file(std::string &file_path, structLogFormat *fmt){
-        std::string format;
-        get_file_format(file_path, format);
-        if (format!=".yaml") return;
-    }
-
     /**
      * @brief This function get home location of operating system.
      * 
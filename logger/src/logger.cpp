@@ -1,7 +1,191 @@
 #include <logger.h>
 
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <csignal>
+#include <filesystem>
+
+#if !defined(PLATFORM_WINDOWS)
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+#if defined(PLATFORM_LINUX)
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/inotify.h>
+#endif
+
 using namespace logger;
 
+namespace logger{
+
+    /**
+     * @struct structThreadBuffer
+     *
+     * @brief This struct defines the asynchronous buffer of a producer thread
+    */
+    struct structThreadBuffer{
+        SpscRingBuffer<structLogMsg> queue;         ///< Messages waiting for the writer thread
+        std::atomic<bool> is_retired{false};        ///< Set when the owner thread exits. The buffer is released once drained.
+        std::atomic<uint32_t> in_flight{0};         ///< Set while the owner thread is pushing. Stop of asynchronous logging waits until it is cleared.
+
+        explicit structThreadBuffer(std::size_t capacity): queue(capacity){}
+    };
+}
+
+namespace{
+
+    /**
+     * @struct structThreadBufferHandle
+     *
+     * @brief This struct keeps the buffer of the thread alive and retires it when the thread exits
+    */
+    struct structThreadBufferHandle{
+        std::shared_ptr<structThreadBuffer> buffer;
+
+        ~structThreadBufferHandle();
+    };
+
+    thread_local structThreadBufferHandle thread_buffer_handle;
+
+    // Trivially destructible, so it can still be read after the handle is destroyed
+    thread_local bool is_thread_buffer_released = false;
+
+    structThreadBufferHandle::~structThreadBufferHandle(){
+        is_thread_buffer_released = true;
+        if (buffer) buffer->is_retired.store(true, std::memory_order_release);
+        buffer.reset();
+    }
+
+    /**
+     * @struct structDuplicateSlot
+     *
+     * @brief This struct keeps the last message of a call site and how many times it is repeated
+    */
+    struct structDuplicateSlot{
+        std::mutex mutex;
+        const structSourceLocation *location = nullptr;             ///< Call site. Null if the slot is unused.
+        enumLogLevel log_level = enumLogLevel::INFO_;               ///< Level of the last message
+        uint64_t msg_hash = 0;                                      ///< Hash of the last message
+        std::size_t msg_size = 0;                                   ///< Length of the last message
+        uint64_t repeat_count = 0;                                  ///< Repeats since the last written line
+        std::chrono::steady_clock::time_point first_repeat{};       ///< Time of the first counted repeat
+    };
+
+    // Call sites are mapped to slots by address of their location. A call site that takes over a slot ends the repeats of the previous one.
+    structDuplicateSlot duplicate_slots[DEFAULT_DUPLICATE_SLOT_COUNT];
+
+    /**
+     * @struct structInternedSource
+     *
+     * @brief This struct keeps the source location of a call site that is known only at runtime (e.g. set by set_log_level)
+    */
+    struct structInternedSource{
+        std::string text;                   ///< Source field as "basename:line"
+        structSourceLocation location;      ///< Location that refers to the text
+    };
+
+    std::mutex interned_sources_mutex;
+    std::map<std::pair<const char*, int>, std::unique_ptr<structInternedSource>> interned_sources;
+
+    // Categories are sorted by name, so a parent always comes before its children
+    std::mutex categories_mutex;
+    std::map<std::string, std::unique_ptr<structCategoryNode>, std::less<>> categories;
+
+    /**
+     * @struct structSinkListCache
+     *
+     * @brief This struct keeps the list of sinks last read by the thread, so the shared list is loaded only after it is replaced
+    */
+    struct structSinkListCache{
+        std::shared_ptr<const std::vector<std::shared_ptr<LogSink>>> sinks;
+        uint64_t version = 0;               ///< Version of the list. Published lists start from one.
+
+        ~structSinkListCache();
+    };
+
+    thread_local structSinkListCache sink_list_cache;
+
+    // Trivially destructible, so it can still be read after the cache is destroyed
+    thread_local bool is_sink_list_cache_released = false;
+
+    structSinkListCache::~structSinkListCache(){
+        is_sink_list_cache_released = true;
+    }
+
+    thread_local structLogMsg scratch_msg;
+
+    // Returns the message of the thread that is reused by log calls
+    structLogMsg &reset_scratch_msg(){
+        scratch_msg.log_level_desc.clear();
+        scratch_msg.source = nullptr;
+        scratch_msg.category = {};
+        scratch_msg.settings = nullptr;
+        scratch_msg.msg.clear();
+        scratch_msg.fields.clear();
+        return scratch_msg;
+    }
+
+    // Set on the asynchronous writer thread, so the crash handler knows whether the writer itself has crashed
+    thread_local bool is_writer_thread = false;
+
+    int64_t steady_now_ns(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Signals handled by the crash handler and the handlers that were installed before it
+    #if defined(PLATFORM_WINDOWS)
+        const int crash_signals[] = {SIGSEGV, SIGABRT, SIGFPE};
+        void (*previous_crash_handlers[sizeof(crash_signals) / sizeof(crash_signals[0])])(int);
+    #else
+        const int crash_signals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE};
+        struct sigaction previous_crash_actions[sizeof(crash_signals) / sizeof(crash_signals[0])];
+    #endif
+
+    void restore_crash_handler(std::size_t index){
+        #if defined(PLATFORM_WINDOWS)
+            std::signal(crash_signals[index], previous_crash_handlers[index]);
+        #else
+            sigaction(crash_signals[index], &previous_crash_actions[index], nullptr);
+        #endif
+    }
+
+    // Set on the thread that handles the first crash, so a crash inside the handler itself is not waited for
+    thread_local bool is_crash_handling_thread = false;
+
+    // Sleeps a millisecond in the crash handler, where only async-signal-safe functions can be called
+    void crash_sleep_1ms(){
+        #if defined(PLATFORM_WINDOWS)
+            Sleep(1);
+        #else
+            struct timespec interval = {0, 1000000};
+            nanosleep(&interval, nullptr);
+        #endif
+    }
+
+    // Blocks a crashing thread until the thread that handles the first crash ends the process
+    [[noreturn]] void wait_for_crash_exit(){
+        for (;;){
+            #if defined(PLATFORM_WINDOWS)
+                Sleep(1000);
+            #else
+                pause();
+            #endif
+        }
+    }
+
+    uint64_t hash_message(std::string_view msg, uint64_t hash = 14695981039346656037ULL){
+        // FNV-1a
+        for (unsigned char c: msg){
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
 /*********************************************************************
  * 
  * Static Variables 
@@ -10,42 +194,89 @@ using namespace logger;
 
 Logger *Logger::ptr_instance_{nullptr};
 std::mutex Logger::mutex_;
-structLogFormat Logger::fmt_{};
 
 std::string Logger::config_file_path_ = "";
-std::string Logger::out_file_dir_ = "";
-std::string Logger::out_filename_ = "";
-std::string Logger::root_filename_ = "";
 
-enumLogLevel Logger::current_level_ = enumLogLevel::INFO_;
+LogFile Logger::binary_file_{DEFAULT_FILE_BUFFER_SIZE};
+std::mutex Logger::binary_mutex_;
+std::atomic<bool> Logger::is_binary_enabled_{false};
+std::atomic<uint64_t> Logger::binary_bytes_written_{0};
+std::atomic<uint32_t> Logger::call_site_counter_{0};
+std::vector<bool> Logger::binary_sites_written_{};
 
 bool Logger::is_output_set_ = false;
 bool Logger::is_configure_set_ = false;
 bool Logger::is_thread_safe_ = false;
-bool Logger::color_enabled_ = false;
-bool Logger::is_source_enabled_ = false;
-
-uint64_t Logger::err_counter_ = 0;
-
-std::ofstream Logger::log_file_{};
-
-std::string Logger::log_source_file_ = "";
-int Logger::log_source_line_ = 0;
-
-std::map<enumLogLevel, structLogLevel> Logger::mapLogLevel{
-    {enumLogLevel::FATAL_, {"FATAL", std::string(COLOR_MAGENTA) }},
-    {enumLogLevel::ERROR_, {"ERROR", std::string(COLOR_RED) }},
-    {enumLogLevel::ALERT_, {"ALERT", std::string(COLOR_BRIGHT_YELLOW) }},
-    {enumLogLevel::WARNING_, {"WARNING", std::string(COLOR_YELLOW) }},
-    {enumLogLevel::INFO_, {"INFO", std::string(COLOR_WHITE) }},
-    {enumLogLevel::DEBUG_, {"DEBUG", std::string(COLOR_CYAN), SHOW_SOURCE_INFO }},
-    {enumLogLevel::TRACE_, {"TRACE", std::string(COLOR_GREEN), SHOW_SOURCE_INFO }},
-    {enumLogLevel::INVALID_, {"INVALID", std::string(COLOR_RESET) }},
-    {enumLogLevel::LOG_ERROR_, {"LOG ERROR",  std::string(COLOR_BG_RED) }}
+
+std::atomic<uint64_t> Logger::err_counter_{0};
+
+thread_local structLogContext Logger::context_{};
+
+// Indexed by enumLogLevel
+const structLogLevel Logger::level_table_[LOG_LEVEL_COUNT]{
+    {"FATAL", std::string(COLOR_MAGENTA) },
+    {"ERROR", std::string(COLOR_RED) },
+    {"ALERT", std::string(COLOR_BRIGHT_YELLOW) },
+    {"WARNING", std::string(COLOR_YELLOW) },
+    {"INFO", std::string(COLOR_WHITE) },
+    {"DEBUG", std::string(COLOR_CYAN), SHOW_SOURCE_INFO },
+    {"TRACE", std::string(COLOR_GREEN), SHOW_SOURCE_INFO },
+    {"LOG ERROR",  std::string(COLOR_BG_RED) },
+    {"INVALID", std::string(COLOR_RESET) }
 };
 
-bool Logger::timestamp_suffix_enabled_ = false;
-structTimestamp Logger::currentTimestamp_{};
+std::vector<std::unique_ptr<LineFormatter>> Logger::formatters_{};
+std::mutex Logger::formatters_mutex_;
+
+std::vector<std::unique_ptr<const structLogSettings>> Logger::settings_list_{};
+std::mutex Logger::settings_mutex_;
+std::atomic<const structLogSettings*> Logger::settings_{Logger::intern_settings_({LOGGER_LEVEL_TRACE,
+    Logger::intern_formatter_({DEFAULT_TIMESTAMP_FORMAT, DEFAULT_DELIMITER_TYPE, DEFAULT_PADDING_SIZE}), false, false})};
+
+std::shared_ptr<ConsoleSink> Logger::console_sink_ = std::make_shared<ConsoleSink>();
+std::shared_ptr<FileSink> Logger::file_sink_ = std::make_shared<FileSink>();
+std::mutex Logger::sinks_mutex_;
+std::shared_ptr<const std::vector<std::shared_ptr<LogSink>>> Logger::sinks_{
+    std::make_shared<const std::vector<std::shared_ptr<LogSink>>>(std::vector<std::shared_ptr<LogSink>>{Logger::console_sink_, Logger::file_sink_})};
+std::atomic<uint64_t> Logger::sinks_version_{1};
+std::atomic<const std::vector<std::shared_ptr<LogSink>>*> Logger::current_sinks_{Logger::sinks_.get()};
+
+std::vector<std::shared_ptr<structThreadBuffer>> Logger::thread_buffers_{};
+std::mutex Logger::thread_buffers_mutex_;
+std::atomic<uint64_t> Logger::thread_buffers_version_{0};
+std::atomic<std::size_t> Logger::async_capacity_{DEFAULT_ASYNC_QUEUE_CAPACITY};
+std::thread Logger::async_writer_{};
+std::atomic<bool> Logger::is_async_enabled_{false};
+std::atomic<bool> Logger::async_stop_requested_{false};
+enumOverflowPolicy Logger::async_overflow_policy_ = DEFAULT_ASYNC_OVERFLOW_POLICY;
+std::atomic<uint64_t> Logger::async_dropped_counter_{0};
+
+std::atomic<int64_t> Logger::async_drain_deadline_ns_{INT64_MAX};
+std::atomic<bool> Logger::crash_flush_requested_{false};
+std::atomic<bool> Logger::crash_flush_done_{false};
+std::atomic<bool> Logger::is_crash_handler_enabled_{false};
+
+std::atomic<bool> Logger::is_duplicate_suppression_enabled_{false};
+std::atomic<uint32_t> Logger::duplicate_interval_ms_{DEFAULT_DUPLICATE_INTERVAL_MS};
+
+std::vector<std::unique_ptr<const structLogConfig>> Logger::configs_{};
+std::mutex Logger::config_mutex_;
+std::atomic<const structLogConfig*> Logger::config_{nullptr};
+std::thread Logger::config_watcher_{};
+std::mutex Logger::config_watch_mutex_;
+std::condition_variable Logger::config_watch_cv_;
+std::atomic<bool> Logger::config_watch_stop_requested_{false};
+int Logger::config_watch_fd_ = -1;
+int Logger::config_watch_wd_ = -1;
+
+std::thread Logger::housekeeping_thread_{};
+std::mutex Logger::housekeeping_mutex_;
+std::condition_variable Logger::housekeeping_cv_;
+structPruneRequest Logger::prune_request_{};
+bool Logger::is_prune_requested_ = false;
+bool Logger::housekeeping_stop_requested_ = false;
+bool Logger::is_console_flush_requested_ = false;
+bool Logger::is_housekeeping_wake_requested_ = false;
 
 /*********************************************************************
  * 
@@ -53,172 +284,681 @@ structTimestamp Logger::currentTimestamp_{};
  * 
 *********************************************************************/
 
-std::string Logger::log_out_(const structLogMsg &msg_log){
-    std::string out = "";
-    
-    std::string str_timestamp = format_time(msg_log.timestamp, fmt_.fmt_timestamp);
-    add_field(str_timestamp, out, fmt_);
-    if (msg_log.log_level_desc == ""){
-            add_field(mapLogLevel[msg_log.log_level].desc, out, fmt_);
+structLineLayout Logger::compile_layout_(const structLogFormat &fmt){
+    structLogFormat layout_fmt = fmt;
+    structLineLayout layout;
+
+    layout.has_timestamp = !fmt.fmt_timestamp.empty();
+    add_padding(layout.separator, layout_fmt);
+    add_delimiter(layout.separator, layout_fmt);
+    for (std::size_t idx=0; idx<LOG_LEVEL_COUNT; idx++){
+        layout.level_tags[idx] = (layout.has_timestamp? layout.separator: "") + level_table_[idx].desc;
+        layout.level_names[idx] = level_table_[idx].desc;
     }
-    else{
-            add_field(msg_log.log_level_desc, out, fmt_);
-    } 
-    add_field(msg_log.source, out, fmt_);
-    add_field(msg_log.msg, out, fmt_);
-    add_newline(out);
-    
-    lstrip_delimiter(out, fmt_);
-    return out;
+    add_newline(layout.newline);
+    return layout;
 }
 
-void Logger::write_console_(const structLogMsg &msg_log){
-    std::string out = "";
-    out = log_out_(msg_log);
+const LineFormatter *Logger::intern_formatter_(const structLogFormat &fmt){
+    std::lock_guard<std::mutex> lock(formatters_mutex_);
+    for (const auto &formatter: formatters_){
+        const structLogFormat &f = formatter->get_format();
+        if (f.fmt_timestamp == fmt.fmt_timestamp && f.fmt_delimiter_type == fmt.fmt_delimiter_type && f.fmt_padding_size == fmt.fmt_padding_size &&
+            f.fmt_output == fmt.fmt_output){
+            return formatter.get();
+        }
+    }
+    // Timestamp format and line layout are compiled once here instead of on every message
+    formatters_.emplace_back(new LineFormatter(fmt, compile_layout_(fmt)));
+    return formatters_.back().get();
+}
 
-    if (color_enabled_)
-        std::cout << pick_log_color_(msg_log.log_level) << out << COLOR_RESET;
-    else
-        std::cout << out;
-    std::cout.flush();
+const structLogSettings *Logger::intern_settings_(const structLogSettings &settings){
+    // Equal settings share a snapshot, so switching a setting back and forth does not grow the list
+    for (const auto &snapshot: settings_list_){
+        if (snapshot->level_threshold == settings.level_threshold && snapshot->formatter == settings.formatter &&
+            snapshot->is_source_enabled == settings.is_source_enabled && snapshot->is_colors_enabled == settings.is_colors_enabled){
+            return snapshot.get();
+        }
+    }
+    settings_list_.emplace_back(new structLogSettings(settings));
+    return settings_list_.back().get();
 }
 
-void Logger::write_file_(const structLogMsg &msg_log){
-    if (out_filename_ == "") return;
+void Logger::publish_settings_(const structLogSettings &settings){
+    settings_.store(intern_settings_(settings), std::memory_order_release);
+}
 
-    std::string out = "";
-    out = log_out_(msg_log);
+void Logger::publish_sinks_(std::vector<std::shared_ptr<LogSink>> sinks){
+    auto list = std::make_shared<const std::vector<std::shared_ptr<LogSink>>>(std::move(sinks));
+    current_sinks_.store(list.get(), std::memory_order_release);
+    std::atomic_store(&sinks_, std::move(list));
+    sinks_version_.fetch_add(1, std::memory_order_release);
+}
+
+const std::vector<std::shared_ptr<LogSink>> &Logger::get_sinks_(){
+    // Thread is exiting and its cache is destroyed, so the current list is read directly
+    if (is_sink_list_cache_released) return *current_sinks_.load(std::memory_order_acquire);
+
+    uint64_t version = sinks_version_.load(std::memory_order_acquire);
+    if (sink_list_cache.version != version){
+        sink_list_cache.sinks = std::atomic_load(&sinks_);
+        sink_list_cache.version = version;
+    }
+    return *sink_list_cache.sinks;
+}
+
+void Logger::write_outputs_(const structLogMsg &msg_log){
+    // Lines are kept per thread and reused, so their capacity is allocated once
+    thread_local std::vector<std::pair<const LineFormatter*, std::string>> lines;
+    std::size_t line_count = 0;
+
+    const LineFormatter *default_formatter = ((msg_log.settings != nullptr)? msg_log.settings: get_settings())->formatter;
+    for (const auto &sink: get_sinks_()){
+        if (!sink->should_log(msg_log.log_level)) continue;
+
+        const LineFormatter *formatter = sink->get_formatter();
+        if (formatter == nullptr) formatter = default_formatter;
+
+        // Message is formatted once per distinct format
+        std::size_t idx = 0;
+        while (idx < line_count && lines[idx].first != formatter) idx++;
+        if (idx == line_count){
+            if (lines.size() == line_count) lines.emplace_back();
+            lines[idx].first = formatter;
+            lines[idx].second.clear();
+            // Only sampled messages are timed, so the clock is not read for every line
+            if (LogStats::should_time_format()){
+                auto start = std::chrono::steady_clock::now();
+                formatter->format(msg_log, lines[idx].second);
+                LogStats::add_format_time((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            }
+            else{
+                formatter->format(msg_log, lines[idx].second);
+            }
+            line_count++;
+        }
+        sink->write(msg_log, lines[idx].second);
+    }
+}
 
-    if(timestamp_suffix_enabled_){
+void Logger::commit_sinks_(bool force){
+    for (const auto &sink: get_sinks_()) sink->commit(force);
+}
 
-        if(currentTimestamp_.tm_year == msg_log.timestamp.tm_year &&
-           currentTimestamp_.tm_mon  == msg_log.timestamp.tm_mon &&
-           currentTimestamp_.tm_mday == msg_log.timestamp.tm_mday){
-            // No change in date
+void Logger::request_prune_(const structPruneRequest &request){
+    std::unique_lock<std::mutex> lock(housekeeping_mutex_);
+    if (housekeeping_stop_requested_){
+        // Housekeeping thread is stopped on exit, so the files are pruned on the caller
+        lock.unlock();
+        FileSink::prune_rotated_files(request);
+        return;
+    }
+
+    start_housekeeping_();
+    // Only the latest request matters, since each one covers all rotated files
+    prune_request_ = request;
+    is_prune_requested_ = true;
+    housekeeping_cv_.notify_one();
+}
+
+void Logger::start_housekeeping_(){
+    if (housekeeping_thread_.joinable() || housekeeping_stop_requested_) return;
+
+    register_exit_handler_();
+    housekeeping_thread_ = std::thread(housekeeping_loop_);
+}
+
+void Logger::start_console_flush_(){
+    std::lock_guard<std::mutex> lock(housekeeping_mutex_);
+    if (is_console_flush_requested_) return;
+    start_housekeeping_();
+    is_console_flush_requested_ = true;
+    is_housekeeping_wake_requested_ = true;
+    housekeeping_cv_.notify_one();
+}
+
+void Logger::housekeeping_loop_(){
+    std::unique_lock<std::mutex> lock(housekeeping_mutex_);
+    auto is_work_pending = [](){ return is_prune_requested_ || housekeeping_stop_requested_ || is_housekeeping_wake_requested_; };
+    for (;;){
+        // Batches of idle sinks and pending lines of the block-buffered console are written within the latency bound
+        uint64_t max_latency_us = LogSink::get_batch_max_latency_us();
+        if (max_latency_us == 0 || LogSink::get_batch_max_records() <= 1) max_latency_us = UINT64_MAX;
+        if (is_console_flush_requested_) max_latency_us = std::min<uint64_t>(max_latency_us, DEFAULT_CONSOLE_FLUSH_INTERVAL_MS * 1000ULL);
+        uint32_t duplicate_interval_ms = duplicate_interval_ms_.load(std::memory_order_relaxed);
+        bool is_duplicate_check_due = is_duplicate_suppression_enabled_.load(std::memory_order_relaxed) && duplicate_interval_ms > 0;
+        if (is_duplicate_check_due) max_latency_us = std::min<uint64_t>(max_latency_us, duplicate_interval_ms * 1000ULL);
+        if (max_latency_us != UINT64_MAX){
+            housekeeping_cv_.wait_for(lock, std::chrono::microseconds(max_latency_us), is_work_pending);
         }
         else{
-            // Update current timestamp on the change of date
-            currentTimestamp_ = msg_log.timestamp;
-            out_filename_ = add_timestamp_prefix_(msg_log.timestamp);
+            housekeeping_cv_.wait(lock, is_work_pending);
+        }
+
+        if (is_prune_requested_){
+            structPruneRequest request = prune_request_;
+            is_prune_requested_ = false;
+            lock.unlock();
+            FileSink::prune_rotated_files(request);
+            lock.lock();
+            continue;
         }
+        if (housekeeping_stop_requested_) break;
+        if (is_housekeeping_wake_requested_){
+            // Settings are changed, so the wait time is computed again
+            is_housekeeping_wake_requested_ = false;
+            continue;
+        }
+
+        lock.unlock();
+        commit_sinks_(false);
+        if (is_duplicate_check_due) flush_repeat_summaries_(false);
+        lock.lock();
     }
-    // Open file in append mode
-    log_file_.open(out_file_dir_ + out_filename_, std::ios::app);
-    if(log_file_.is_open()) log_file_  << out;
-    else error_handler_("Log file cannot be opened.");
-    log_file_.close();
 }
 
-void Logger::error_handler_(const std::string &err_msg){
-    structTimestamp ts;
-    get_current_timestamp_struct(ts);
-    
-    set_log_level(enumLogLevel::LOG_ERROR_);
+void Logger::stop_housekeeping_(){
+    {
+        std::lock_guard<std::mutex> lock(housekeeping_mutex_);
+        housekeeping_stop_requested_ = true;
+    }
+    housekeeping_cv_.notify_one();
+    if (housekeeping_thread_.joinable()) housekeeping_thread_.join();
+}
 
-    if (err_counter_<UINT64_MAX) err_counter_++;
+void Logger::apply_config_(const structLogConfig &config, const structLogConfig *previous){
+    // Keys of the file are applied when they are new or their values change, so settings made at runtime are kept otherwise
+    auto is_changed = [&config, previous](uint32_t keys, auto get){
+        if ((config.keys & keys) == 0) return false;
+        return previous == nullptr || (previous->keys & keys) != (config.keys & keys) || get(*previous) != get(config);
+    };
 
-    structLogMsg err_log;
-    err_log.timestamp = ts;
-    err_log.log_level = current_level_;
-    err_log.log_level_desc = "[" + mapLogLevel[current_level_].desc + " " + std::to_string(err_counter_) + "]";
-    
-    err_log.source = ((bool) ((mapLogLevel[current_level_].option & MASK_SHOW_SOURCE_INFO) != 0) && is_source_enabled_)? log_source_file_ + ":" + std::to_string(log_source_line_): "";
-    err_log.msg = std::string(err_msg);
-    
-    std::string out = "";
-    out = log_out_(err_log);
+    {
+        // Settings read by log calls are published as a single snapshot, so a log call never sees half of a reload
+        std::lock_guard<std::mutex> lock(categories_mutex);
+        std::lock_guard<std::mutex> settings_lock(settings_mutex_);
+        structLogSettings settings = *settings_.load(std::memory_order_relaxed);
+        if (is_changed(CONFIG_KEY_LEVEL, [](const structLogConfig &c){ return c.level_threshold; })) settings.level_threshold = (int) config.level_threshold;
+        if (is_changed(CONFIG_KEY_SOURCE, [](const structLogConfig &c){ return c.is_source_enabled; })) settings.is_source_enabled = config.is_source_enabled;
+        if (is_changed(CONFIG_KEY_COLORS, [](const structLogConfig &c){ return c.is_colors_enabled; })) settings.is_colors_enabled = config.is_colors_enabled;
+
+        structLogFormat fmt = settings.formatter->get_format();
+        if (is_changed(CONFIG_KEY_FORMAT_TIMESTAMP, [](const structLogConfig &c){ return c.format.fmt_timestamp; })) fmt.fmt_timestamp = config.format.fmt_timestamp;
+        if (is_changed(CONFIG_KEY_FORMAT_DELIMITER, [](const structLogConfig &c){ return c.format.fmt_delimiter_type; })) fmt.fmt_delimiter_type = config.format.fmt_delimiter_type;
+        if (is_changed(CONFIG_KEY_FORMAT_PADDING, [](const structLogConfig &c){ return c.format.fmt_padding_size; })) fmt.fmt_padding_size = config.format.fmt_padding_size;
+        if (is_changed(CONFIG_KEY_FORMAT_OUTPUT, [](const structLogConfig &c){ return c.format.fmt_output; })) fmt.fmt_output = config.format.fmt_output;
+        settings.formatter = intern_formatter_(fmt);
+
+        publish_settings_(settings);
+        resolve_category_levels_();
+    }
 
-    if (color_enabled_){
-        out = pick_log_color_(err_log.log_level) + out;
-        if (out.size() > 0) out.insert(out.size()-1, COLOR_RESET);
-        std::cout << out << COLOR_RESET;
+    // Policy and threshold are applied together. A missing one takes its default value.
+    if (is_changed(CONFIG_KEY_FLUSH_POLICY | CONFIG_KEY_FLUSH_THRESHOLD, [](const structLogConfig &c){ return std::make_pair(c.flush_policy, c.flush_threshold); })){
+        file_sink_->set_flush_policy(config.flush_policy, config.flush_threshold);
     }
-    else{
-        std::cout << out;
+    if (is_changed(CONFIG_KEY_FILE_BUFFER_SIZE, [](const structLogConfig &c){ return c.file_buffer_size; })) file_sink_->set_buffer_size(config.file_buffer_size);
+    if (is_changed(CONFIG_KEY_BATCH_MAX_RECORDS | CONFIG_KEY_BATCH_MAX_LATENCY_US,
+                   [](const structLogConfig &c){ return std::make_pair(c.batch_max_records, c.batch_max_latency_us); })){
+        set_batch_policy(((config.keys & CONFIG_KEY_BATCH_MAX_RECORDS) != 0)? config.batch_max_records: LogSink::get_batch_max_records(),
+                         ((config.keys & CONFIG_KEY_BATCH_MAX_LATENCY_US) != 0)? config.batch_max_latency_us: LogSink::get_batch_max_latency_us());
+    }
+
+    if (config.output_filename.empty()) return;
+    if (!is_output_set_){
+        set_output_(config.output_filename, config.output_dir, config.is_timestamp_prefix_enabled);
+    }
+    else if (previous == nullptr || previous->output_filename != config.output_filename || previous->output_dir != config.output_dir ||
+             previous->is_timestamp_prefix_enabled != config.is_timestamp_prefix_enabled){
+        error_handler_("Output file can be set only once.");
     }
-    std::cout.flush();
 }
 
-inline std::string Logger::pick_log_color_(enumLogLevel log_level){
-    for(auto &elem: mapLogLevel){
-        if (log_level == elem.first){
-            return elem.second.color;
+void Logger::start_config_watch_(){
+    if (config_watcher_.joinable()) return;
+    config_watch_stop_requested_.store(false);
+
+    #if defined(PLATFORM_LINUX)
+        // Directory is watched, since editors often replace the file instead of writing to it
+        std::filesystem::path dir = std::filesystem::path(config_file_path_).parent_path();
+        config_watch_fd_ = inotify_init1(IN_CLOEXEC);
+        if (config_watch_fd_ >= 0) config_watch_wd_ = inotify_add_watch(config_watch_fd_, dir.empty()? ".": dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (config_watch_fd_ < 0 || config_watch_wd_ < 0){
+            if (config_watch_fd_ >= 0) close(config_watch_fd_);
+            config_watch_fd_ = -1;
+            error_handler_("Configuration file cannot be watched: " + config_file_path_);
+            return;
         }
+    #endif
+    config_watcher_ = std::thread(config_watch_loop_);
+}
+
+void Logger::stop_config_watch_(){
+    if (!config_watcher_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(config_watch_mutex_);
+        config_watch_stop_requested_.store(true);
     }
-    return mapLogLevel[enumLogLevel::INVALID_].color;
+    #if defined(PLATFORM_LINUX)
+        // Removing the watch queues an event, which wakes the watcher up
+        inotify_rm_watch(config_watch_fd_, config_watch_wd_);
+    #endif
+    config_watch_cv_.notify_one();
+    config_watcher_.join();
+
+    #if defined(PLATFORM_LINUX)
+        close(config_watch_fd_);
+        config_watch_fd_ = -1;
+        config_watch_wd_ = -1;
+    #endif
+}
+
+void Logger::config_watch_loop_(){
+    std::filesystem::path path(config_file_path_);
+
+    #if defined(PLATFORM_LINUX)
+        std::string filename = path.filename().string();
+        alignas(struct inotify_event) char events[4096];
+        while (!config_watch_stop_requested_.load()){
+            struct pollfd pfd{config_watch_fd_, POLLIN, 0};
+            if (poll(&pfd, 1, -1) <= 0) continue;
+            if ((pfd.revents & (POLLERR | POLLNVAL)) != 0) break;
+
+            ssize_t size = read(config_watch_fd_, events, sizeof(events));
+            bool is_changed = false;
+            for (ssize_t pos = 0; pos < size; ){
+                const struct inotify_event *event = (const struct inotify_event*) (events + pos);
+                if (event->len > 0 && filename == event->name) is_changed = true;
+                pos += (ssize_t) (sizeof(struct inotify_event) + event->len);
+            }
+            if (is_changed && !config_watch_stop_requested_.load()) reload_config();
+        }
+    #else
+        std::error_code ec;
+        auto last_write_time = std::filesystem::last_write_time(path, ec);
+        std::unique_lock<std::mutex> lock(config_watch_mutex_);
+        while (!config_watch_cv_.wait_for(lock, std::chrono::milliseconds(DEFAULT_CONFIG_POLL_MS), [](){ return config_watch_stop_requested_.load(); })){
+            auto write_time = std::filesystem::last_write_time(path, ec);
+            if (ec || write_time == last_write_time) continue;
+            last_write_time = write_time;
+            lock.unlock();
+            reload_config();
+            lock.lock();
+        }
+    #endif
 }
 
-inline std::string Logger::add_timestamp_prefix_(structTimestamp ts){
-    std::string result;
-    std::string timestamp_prefix = "";
-    timestamp_prefix = format_time(ts, DEFAULT_TIMESTAMP_PREFIX_FORMAT);
-    if (root_filename_.empty()){
-        std::string format;
-        get_file_format(root_filename_, format);
-        format = format.empty()? std::string(DEFAULT_LOG_EXTENSION): format;
-        result = timestamp_prefix + format;
+void Logger::register_exit_handler_(){
+    // Singleton instance is never destroyed, so pending messages are drained by an exit handler
+    static std::once_flag once;
+    std::call_once(once, [](){ std::atexit([](){ shutdown(); }); });
+}
+
+void Logger::write_binary_record_(const structCallSite &site, uint32_t site_id, const structLogSettings &settings, const std::string &payload){
+    thread_local std::string entry;
+    entry.clear();
+
+    int64_t ts_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    uint8_t flags = ((level_table_[level_index_(site.log_level)].option & MASK_SHOW_SOURCE_INFO) != 0 && settings.is_source_enabled)? BINARY_FLAG_SOURCE_ENABLED: 0;
+
+    append_binary(entry, (char) BINARY_ENTRY_RECORD);
+    append_binary(entry, site_id);
+    append_binary(entry, ts_ns);
+    append_binary(entry, flags);
+    append_binary(entry, (uint32_t) payload.size());
+    entry += payload;
+
+    std::lock_guard<std::mutex> lock(binary_mutex_);
+    if (site_id >= binary_sites_written_.size()) binary_sites_written_.resize(site_id + 1, false);
+    if (!binary_sites_written_[site_id]){
+        // Metadata of the call site is written once per file, so the file can be decoded on its own
+        std::string site_entry;
+        std::size_t file_len = std::strlen(site.file);
+        std::size_t fmt_len = std::strlen(site.fmt);
+        append_binary(site_entry, (char) BINARY_ENTRY_CALL_SITE);
+        append_binary(site_entry, site_id);
+        append_binary(site_entry, (uint8_t) site.log_level);
+        append_binary(site_entry, (int32_t) site.line);
+        append_binary(site_entry, (uint32_t) file_len);
+        site_entry.append(site.file, file_len);
+        append_binary(site_entry, (uint32_t) fmt_len);
+        site_entry.append(site.fmt, fmt_len);
+        binary_file_.write(site_entry.data(), site_entry.size());
+        binary_sites_written_[site_id] = true;
+        binary_bytes_written_.fetch_add(site_entry.size(), std::memory_order_relaxed);
     }
-    else{
-        result = timestamp_prefix + "_" + root_filename_;
+
+    if (!binary_file_.write(entry.data(), entry.size())){
+        error_handler_("Binary log file cannot be written.");
+        return;
     }
-    return result;
+    binary_bytes_written_.fetch_add(entry.size(), std::memory_order_relaxed);
+    LogStats::add_message(site.log_level);
+    if (site.log_level == enumLogLevel::FATAL_ || site.log_level == enumLogLevel::ERROR_) binary_file_.flush();
 }
 
-void Logger::set_output_(const std::string &filename, const std::string file_dir, bool timestamp_prefix_enabled){
-    std::string temp_out_filename = "";
-    root_filename_ = std::string(filename);
-    std::string file_format;
+void Logger::log_formatted_(const structCallSite &site, const structLogSettings &settings, const std::string &payload){
+    structLogMsg &log = reset_scratch_msg();
+    get_current_timestamp_struct(log.timestamp);
+    log.log_level = site.log_level;
+    log.source = make_source_(settings, site.log_level, site.location);
+    log.settings = &settings;
+    if (!format_binary_args(site.fmt, payload.data(), payload.size(), log.msg)){
+        error_handler_("Arguments cannot be formatted: " + std::string(site.fmt));
+        return;
+    }
 
-    if (timestamp_prefix_enabled){
-        structTimestamp ts;
-        get_current_timestamp_struct(ts);
-        temp_out_filename = add_timestamp_prefix_(ts);
+    dispatch_(log);
+}
+
+LogRecord Logger::start_record_() noexcept{
+    const structLogSettings *settings = get_settings();
+    if (!settings->is_level_enabled(context_.log_level)) return LogRecord(context_.log_level, nullptr, nullptr);
+    return LogRecord(context_.log_level, intern_source_location_(context_.source_file, context_.source_line), settings);
+}
+
+const structSourceLocation *Logger::make_source_(const structLogSettings &settings, enumLogLevel level, const structSourceLocation *location) noexcept{
+    if ((level_table_[level_index_(level)].option & MASK_SHOW_SOURCE_INFO) == 0 || !settings.is_source_enabled) return nullptr;
+    return location;
+}
+
+const structSourceLocation *Logger::intern_source_location_(const char *file, int line){
+    // Consecutive calls of a thread usually come from the same call site
+    thread_local const structSourceLocation *last_location = nullptr;
+    if (last_location != nullptr && last_location->file == file && last_location->line == line) return last_location;
+
+    std::lock_guard<std::mutex> lock(interned_sources_mutex);
+    std::unique_ptr<structInternedSource> &interned = interned_sources[{file, line}];
+    if (!interned){
+        interned.reset(new structInternedSource);
+        interned->text = std::string(source_basename(file)) + ":" + std::to_string(line);
+        interned->location = {file, line, interned->text.data(), (uint32_t) interned->text.size()};
     }
-    else{
-        temp_out_filename = root_filename_;
+    last_location = &interned->location;
+    return last_location;
+}
+
+bool Logger::suppress_duplicate_(const LogRecord &record){
+    std::string_view msg = record.message();
+    uint64_t hash = hash_message(record.fields_, hash_message(msg));
+    std::size_t msg_size = msg.size() + record.fields_.size();
+    std::size_t site = (std::size_t) ((uintptr_t) record.location_ >> 3);
+    structDuplicateSlot &slot = duplicate_slots[site % DEFAULT_DUPLICATE_SLOT_COUNT];
+
+    // Summary is copied and emitted after the slot is released, since writing it may block on the outputs
+    enumLogLevel summary_level = enumLogLevel::INFO_;
+    const structSourceLocation *summary_location = nullptr;
+    uint64_t summary_count = 0;
+    bool is_suppressed;
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        is_suppressed = slot.location == record.location_ && slot.log_level == record.log_level_ && slot.msg_hash == hash && slot.msg_size == msg_size;
+        if (is_suppressed){
+            LogStats::add_duplicate();
+            auto now = std::chrono::steady_clock::now();
+            if (slot.repeat_count++ == 0) slot.first_repeat = now;
+
+            uint32_t interval_ms = duplicate_interval_ms_.load(std::memory_order_relaxed);
+            if (interval_ms > 0 && now - slot.first_repeat >= std::chrono::milliseconds(interval_ms)){
+                summary_level = slot.log_level;
+                summary_location = slot.location;
+                summary_count = slot.repeat_count;
+                slot.repeat_count = 0;
+            }
+        }
+        else{
+            // Message is changed, so the repeats of the previous one are reported before it
+            summary_level = slot.log_level;
+            summary_location = slot.location;
+            summary_count = slot.repeat_count;
+            slot.location = record.location_;
+            slot.log_level = record.log_level_;
+            slot.msg_hash = hash;
+            slot.msg_size = msg_size;
+            slot.repeat_count = 0;
+        }
     }
 
-    // Check empty filename
-    if (temp_out_filename.empty()){
-        error_handler_("Filename is empty.");
-        return;
+    if (summary_count > 0) emit_repeat_summary_(summary_level, summary_location, summary_count);
+    return is_suppressed;
+}
+
+void Logger::emit_repeat_summary_(enumLogLevel level, const structSourceLocation *location, uint64_t count){
+    structLogMsg log;
+    get_current_timestamp_struct(log.timestamp);
+    log.log_level = level;
+    log.settings = get_settings();
+    log.source = make_source_(*log.settings, level, location);
+    log.msg = "Last message repeated " + std::to_string(count) + " times";
+
+    dispatch_(log);
+}
+
+void Logger::flush_repeat_summaries_(bool force){
+    auto now = std::chrono::steady_clock::now();
+    auto interval = std::chrono::milliseconds(duplicate_interval_ms_.load(std::memory_order_relaxed));
+    for (auto &slot: duplicate_slots){
+        enumLogLevel level;
+        const structSourceLocation *location;
+        uint64_t count;
+        {
+            std::lock_guard<std::mutex> lock(slot.mutex);
+            if (slot.repeat_count == 0) continue;
+            if (!force && (interval.count() == 0 || now - slot.first_repeat < interval)) continue;
+            level = slot.log_level;
+            location = slot.location;
+            count = slot.repeat_count;
+            slot.repeat_count = 0;
+        }
+        emit_repeat_summary_(level, location, count);
     }
+}
 
-    // Check file extension if nothing is provided set to default format (.log).
-    auto r = get_file_format(temp_out_filename, file_format);
-    if (r<0){
-        temp_out_filename += DEFAULT_LOG_EXTENSION;
+void Logger::submit_record_(LogRecord &record){
+    if (is_duplicate_suppression_enabled_.load(std::memory_order_relaxed) && suppress_duplicate_(record)) return;
+
+    // Message of the thread is reused, so its strings are not allocated again once they are large enough
+    structLogMsg &log = reset_scratch_msg();
+    get_current_timestamp_struct(log.timestamp);
+    log.log_level = record.log_level_;
+    log.source = make_source_(*record.settings_, record.log_level_, record.location_);
+    log.category = record.category_;
+    log.settings = record.settings_;
+    log.msg.assign(record.message());
+    if (record.is_truncated_) log.msg += DEFAULT_TRUNCATION_MARKER;
+    if (record.suppressed_count_ > 0){
+        char count[24];
+        auto r = std::to_chars(count, count + sizeof(count), record.suppressed_count_);
+        log.msg += " [";
+        log.msg.append(count, r.ptr);
+        log.msg += " similar messages suppressed]";
     }
-    // Check filename only contains with file extension
-    else if (r==0){
-        error_handler_("Filename is not valid: " + temp_out_filename);
-        return;
+    log.fields.assign(record.fields_);
+
+    dispatch_(log);
+}
+
+structThreadBuffer *Logger::get_thread_buffer_(){
+    if (thread_buffer_handle.buffer) return thread_buffer_handle.buffer.get();
+    if (is_thread_buffer_released) return nullptr;
+
+    auto buffer = std::make_shared<structThreadBuffer>(async_capacity_.load(std::memory_order_relaxed));
+    {
+        std::lock_guard<std::mutex> lock(thread_buffers_mutex_);
+        thread_buffers_.push_back(buffer);
+        thread_buffers_version_.fetch_add(1, std::memory_order_release);
     }
-    else{}
-    
-    // If the file directory is not provided, default log directory is home location
-    std::string temp_out_file_dir = (file_dir=="")? HomeDir: std::string(file_dir);
-    // Append "/" to the end of directory path
-    if (temp_out_file_dir.back() != '/') temp_out_file_dir.push_back('/');
-    // Convert all \ chars to / for cross-platfrom portatibility
-    std::replace(temp_out_file_dir.begin(), temp_out_file_dir.end(), '\\', '/');
-
-    log_file_.open(temp_out_file_dir + temp_out_filename, std::ios::out);
-    if(!log_file_.is_open()){
-        error_handler_("The log file cannot be opened.");
-        return;
+    thread_buffer_handle.buffer = std::move(buffer);
+    return thread_buffer_handle.buffer.get();
+}
+
+void Logger::dispatch_(const structLogMsg &msg_log){
+    if (is_async_enabled_.load(std::memory_order_acquire)){
+        // Messages logged while the thread is being destroyed are written directly
+        structThreadBuffer *buffer = get_thread_buffer_();
+        if (buffer != nullptr){
+            bool is_fatal = msg_log.log_level == enumLogLevel::FATAL_;
+            bool is_pushed = false;
+            // Flag is read again after the push is announced and on every retry. Either stop_async_ waits for the push and
+            // drains it, or the message is written directly, and a producer never waits for a writer that has stopped.
+            buffer->in_flight.fetch_add(1, std::memory_order_seq_cst);
+            while (is_async_enabled_.load(std::memory_order_seq_cst)){
+                // Message is copied, so both the slot and the message of the caller keep their capacity
+                if (buffer->queue.try_push(msg_log)){
+                    is_pushed = true;
+                    break;
+                }
+                if (async_overflow_policy_ == enumOverflowPolicy::DROP && !is_fatal){
+                    buffer->in_flight.fetch_sub(1, std::memory_order_release);
+                    async_dropped_counter_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::yield();
+            }
+            buffer->in_flight.fetch_sub(1, std::memory_order_release);
+            if (is_pushed){
+                // Dropped messages are counted only as dropped
+                LogStats::add_message(msg_log.log_level);
+                if (is_fatal) drain_for_fatal_();
+                return;
+            }
+        }
+    }
+
+    LogStats::add_message(msg_log.log_level);
+    write_outputs_(msg_log);
+    if (msg_log.log_level == enumLogLevel::FATAL_) drain_for_fatal_();
+}
+
+void Logger::drain_for_fatal_(){
+    structThreadBuffer *buffer = is_async_enabled_.load(std::memory_order_acquire)? get_thread_buffer_(): nullptr;
+    if (buffer != nullptr && !is_writer_thread){
+        int64_t deadline = steady_now_ns() + (int64_t) DEFAULT_DRAIN_TIMEOUT_MS * 1000000;
+        while (!buffer->queue.empty() && steady_now_ns() < deadline) std::this_thread::yield();
+    }
+    commit_sinks_(true);
+    for (const auto &sink: get_sinks_()) sink->flush();
+}
+
+std::size_t Logger::drain_async_queue_(int64_t deadline_ns){
+    // Only one thread drains at a time, so the snapshot of the registry is kept between calls
+    static std::vector<std::shared_ptr<structThreadBuffer>> buffers;
+    static uint64_t buffers_version = UINT64_MAX;
+    static std::vector<std::pair<int64_t, std::size_t>> heads;
+
+    uint64_t version = thread_buffers_version_.load(std::memory_order_acquire);
+    if (version != buffers_version){
+        std::lock_guard<std::mutex> lock(thread_buffers_mutex_);
+        buffers = thread_buffers_;
+        buffers_version = thread_buffers_version_.load(std::memory_order_relaxed);
     }
-    log_file_.close();
 
-    out_filename_ = temp_out_filename;
-    out_file_dir_ = temp_out_file_dir;
-    is_output_set_ = true;
+    // Min-heap of the oldest message of each buffer, ordered by timestamp and then by buffer index
+    auto later = [](const std::pair<int64_t, std::size_t> &a, const std::pair<int64_t, std::size_t> &b){ return a > b; };
+    heads.clear();
+    uint64_t depth = 0;
+    for (std::size_t i=0; i<buffers.size(); i++){
+        const structLogMsg *msg_log = buffers[i]->queue.front();
+        if (msg_log != nullptr) heads.emplace_back(msg_log->timestamp.tm_epoch_ns, i);
+        depth += buffers[i]->queue.size_approx();
+    }
+    LogStats::update_queue_depth(depth);
+    std::make_heap(heads.begin(), heads.end(), later);
+
+    std::size_t count = 0;
+    while (!heads.empty()){
+        // Clock is read once per 256 messages, and only while a deadline is set
+        if (deadline_ns != INT64_MAX && count % 256 == 0 && steady_now_ns() >= deadline_ns) break;
+
+        std::pop_heap(heads.begin(), heads.end(), later);
+        std::size_t index = heads.back().second;
+        heads.pop_back();
+
+        auto &queue = buffers[index]->queue;
+        write_outputs_(*queue.front());
+        queue.pop();
+        count++;
+
+        const structLogMsg *next = queue.front();
+        if (next != nullptr){
+            heads.emplace_back(next->timestamp.tm_epoch_ns, index);
+            std::push_heap(heads.begin(), heads.end(), later);
+        }
+    }
+
+    // Retired flag is read before emptiness, so the last messages of an exited thread are never missed
+    bool is_reclaimed = false;
+    for (const auto &buffer: buffers){
+        if (buffer->is_retired.load(std::memory_order_acquire) && buffer->queue.front() == nullptr){
+            std::lock_guard<std::mutex> lock(thread_buffers_mutex_);
+            thread_buffers_.erase(std::remove(thread_buffers_.begin(), thread_buffers_.end(), buffer), thread_buffers_.end());
+            thread_buffers_version_.fetch_add(1, std::memory_order_release);
+            is_reclaimed = true;
+        }
+    }
+    if (is_reclaimed){
+        std::lock_guard<std::mutex> lock(thread_buffers_mutex_);
+        buffers = thread_buffers_;
+        buffers_version = thread_buffers_version_.load(std::memory_order_relaxed);
+    }
+
+    return count;
 }
 
-void Logger::set_format_(structLogFormat &fmt){
-    fmt_.fmt_delimiter_type = fmt.fmt_delimiter_type;
-    fmt_.fmt_padding_size = fmt.fmt_padding_size;
-    fmt_.fmt_timestamp = fmt.fmt_timestamp;
+void Logger::async_writer_loop_(){
+    is_writer_thread = true;
+    for (;;){
+        if (crash_flush_requested_.load(std::memory_order_acquire) && !crash_flush_done_.load(std::memory_order_relaxed)){
+            drain_async_queue_();
+            commit_sinks_(true);
+            for (const auto &sink: get_sinks_()) sink->flush();
+            crash_flush_done_.store(true, std::memory_order_release);
+        }
+
+        // Read the stop flag before draining so that messages pushed before the stop request are never missed
+        bool stop_requested = async_stop_requested_.load(std::memory_order_acquire);
+        int64_t deadline = async_drain_deadline_ns_.load(std::memory_order_relaxed);
+        if (drain_async_queue_(deadline) > 0 && (deadline == INT64_MAX || steady_now_ns() < deadline)) continue;
+        if (stop_requested) break;
+        // Queue is empty, so the records gathered during the burst are written
+        commit_sinks_(true);
+        std::this_thread::sleep_for(std::chrono::microseconds(DEFAULT_ASYNC_IDLE_SLEEP_US));
+    }
+}
+
+void Logger::error_handler_(const std::string &err_msg){
+    structTimestamp ts;
+    get_current_timestamp_struct(ts);
+    
+    // Errors are reported from sinks, the writer thread and the configuration watcher at the same time
+    uint64_t err_count = err_counter_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    // Log context of the thread is not changed, so the message being logged by the caller keeps its level and source
+    structLogMsg err_log;
+    err_log.timestamp = ts;
+    err_log.log_level = enumLogLevel::LOG_ERROR_;
+    err_log.log_level_desc = "[" + level_table_[level_index_(enumLogLevel::LOG_ERROR_)].desc + " " + std::to_string(err_count) + "]";
+    err_log.msg = std::string(err_msg);
+    err_log.settings = get_settings();
+    
+    std::string out = "";
+    err_log.settings->formatter->format(err_log, out);
+
+    // Errors bypass the level of the console sink and are written at once together with pending records
+    console_sink_->write(err_log, out);
+    console_sink_->flush();
+}
+
+void Logger::set_output_(const std::string &filename, const std::string file_dir, bool timestamp_prefix_enabled){
+    if (file_sink_->open(filename, file_dir, timestamp_prefix_enabled)) is_output_set_ = true;
+}
+
+void Logger::set_format_(const structLogFormat &fmt){
+    std::lock_guard<std::mutex> lock(settings_mutex_);
+    structLogSettings settings = *settings_.load(std::memory_order_relaxed);
+    settings.formatter = intern_formatter_(fmt);
+    publish_settings_(settings);
 }
 
 /*********************************************************************
@@ -236,10 +976,8 @@ Logger::Logger() {
 }
 
 Logger::~Logger(){
-    if(log_file_.is_open()) log_file_.close();
-
-    delete ptr_instance_;
-    ptr_instance_ = NULL;
+    // Instance is being deleted by its owner, so it must not delete itself again
+    if (ptr_instance_ == this) ptr_instance_ = nullptr;
 }
 
 /*********************************************************************
@@ -249,7 +987,8 @@ Logger::~Logger(){
 *********************************************************************/
 
 Logger *Logger::getInstance(){
-    if(is_thread_safe_) std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if(is_thread_safe_) lock.lock();
 
     if (ptr_instance_ == nullptr){
         ptr_instance_ = new Logger();
@@ -260,70 +999,6 @@ Logger *Logger::getInstance(){
     }
 }
 
-Logger *Logger::operator<<(char *s_){
-    structLogMsg log;
-    structTimestamp ts;
-    get_current_timestamp_struct(ts);
-    
-    log.timestamp = ts;
-    log.log_level = current_level_;
-    log.source = ((bool) ((mapLogLevel[current_level_].option & MASK_SHOW_SOURCE_INFO) != 0) && is_source_enabled_)? log_source_file_ + ":" + std::to_string(log_source_line_): "";
-    log.msg = std::string(s_);
-
-    write_console_(log);
-    write_file_(log);
-
-    return ptr_instance_;
-}
-
-Logger *Logger::operator<<(const std::string &s_){
-    structLogMsg log;
-    structTimestamp ts;
-    get_current_timestamp_struct(ts);
-    
-    log.timestamp = ts;
-    log.log_level = current_level_;
-    log.source = ((bool) ((mapLogLevel[current_level_].option & MASK_SHOW_SOURCE_INFO) != 0) && is_source_enabled_)? log_source_file_ + ":" + std::to_string(log_source_line_): "";
-    log.msg = s_;
-
-    write_console_(log);
-    write_file_(log);
-
-    return ptr_instance_;
-}
-
-Logger *Logger::operator<<(std::string &s_){
-    structLogMsg log;
-    structTimestamp ts;
-    get_current_timestamp_struct(ts);
-    
-    log.timestamp = ts;
-    log.log_level = current_level_;
-    log.source = ((bool) ((mapLogLevel[current_level_].option & MASK_SHOW_SOURCE_INFO) != 0) && is_source_enabled_)? log_source_file_ + ":" + std::to_string(log_source_line_): "";
-    log.msg = s_;
-
-    write_console_(log);
-    write_file_(log);
-
-    return ptr_instance_;
-}
-
-Logger *Logger::operator<<(const char *s_){
-    structLogMsg log;
-    structTimestamp ts;
-    get_current_timestamp_struct(ts);
-    
-    log.timestamp = ts;
-    log.log_level = current_level_;
-    log.source = ((bool) ((mapLogLevel[current_level_].option & MASK_SHOW_SOURCE_INFO) != 0) && is_source_enabled_)? log_source_file_ + ":" + std::to_string(log_source_line_): "";
-    log.msg = std::string(s_);
-
-    write_console_(log);
-    write_file_(log);
-
-    return ptr_instance_;
-}
-
 void Logger::configure(const std::string file_path){
     if (is_configure_set_){
         error_handler_("Configuration file can be set only once.");
@@ -332,23 +1007,44 @@ void Logger::configure(const std::string file_path){
 
     config_file_path_ = file_path;
     is_configure_set_ = true;
+
+    // Watcher is started even if the file is not valid yet, so the fixed file is applied without a restart
+    reload_config();
+    register_exit_handler_();
+    start_config_watch_();
 }
 
 void Logger::configure(char *file_path){
-    if (is_configure_set_){
-        error_handler_("Configuration file can be set only once.");
-        return;
+    configure(std::string(file_path));
+}
+
+bool Logger::reload_config(){
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (!is_configure_set_) return false;
+
+    std::unique_ptr<structLogConfig> config(new structLogConfig);
+    std::string error;
+    if (!read_config_file(config_file_path_, *config, error)){
+        error_handler_(error);
+        return false;
     }
 
-    config_file_path_ = std::string(file_path);
-    is_configure_set_ = true;
+    apply_config_(*config, config_.load(std::memory_order_relaxed));
+    // Previous snapshots are kept, since readers may still hold them
+    configs_.emplace_back(std::move(config));
+    config_.store(configs_.back().get(), std::memory_order_release);
+    return true;
+}
+
+const structLogConfig *Logger::get_config() noexcept{
+    return config_.load(std::memory_order_acquire);
 }
 
 Logger *Logger::set_log_level(enumLogLevel level, const char *file, int line) noexcept{
-    current_level_ = level;
+    context_.log_level = level;
     
-    log_source_file_ = (file==nullptr)? log_source_file_ : std::string(file);
-    log_source_line_ = (line<0)? log_source_line_ : line;
+    if (file!=nullptr) context_.source_file = file;
+    if (line>=0) context_.source_line = line;
 
     return ptr_instance_;
 }
@@ -374,26 +1070,357 @@ void Logger::set_output(const char *filename, const char *file_dir, bool timesta
     set_output_(temp_out_filename_, temp_out_file_dir_, timestamp_prefix_enabled);
 }
 
-void Logger::enable_colors() noexcept{
-    color_enabled_ = true;
+void Logger::enable_colors(){
+    std::lock_guard<std::mutex> lock(settings_mutex_);
+    structLogSettings settings = *settings_.load(std::memory_order_relaxed);
+    settings.is_colors_enabled = true;
+    publish_settings_(settings);
+}
+
+void Logger::disable_colors(){
+    std::lock_guard<std::mutex> lock(settings_mutex_);
+    structLogSettings settings = *settings_.load(std::memory_order_relaxed);
+    settings.is_colors_enabled = false;
+    publish_settings_(settings);
 }
 
-void Logger::disable_colors() noexcept{
-    color_enabled_ = false;            
+void Logger::set_stderr_routing(bool is_enabled, enumLogLevel level) noexcept{
+    console_sink_->set_stderr_routing(is_enabled, level);
 }
 
 void Logger::set_thread_safety(bool is_safe) noexcept{
     is_thread_safe_ = is_safe;            
 }
 
-void Logger::enable_source() noexcept{
-    is_source_enabled_ = true;
+void Logger::enable_source(){
+    std::lock_guard<std::mutex> lock(settings_mutex_);
+    structLogSettings settings = *settings_.load(std::memory_order_relaxed);
+    settings.is_source_enabled = true;
+    publish_settings_(settings);
 }
 
-void Logger::disable_source() noexcept{
-    is_source_enabled_ = false;
+void Logger::disable_source(){
+    std::lock_guard<std::mutex> lock(settings_mutex_);
+    structLogSettings settings = *settings_.load(std::memory_order_relaxed);
+    settings.is_source_enabled = false;
+    publish_settings_(settings);
 }
 
 std::string Logger::get_log_path() noexcept{
-    return out_file_dir_ + out_filename_;
+    return file_sink_->get_path();
+}
+
+void Logger::add_sink(const std::shared_ptr<LogSink> &sink){
+    if (!sink){
+        error_handler_("Sink cannot be null.");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sinks_mutex_);
+    std::vector<std::shared_ptr<LogSink>> sinks(*sinks_);
+    if (std::find(sinks.begin(), sinks.end(), sink) != sinks.end()) return;
+    sinks.push_back(sink);
+    publish_sinks_(std::move(sinks));
+}
+
+void Logger::remove_sink(const std::shared_ptr<LogSink> &sink){
+    {
+        std::lock_guard<std::mutex> lock(sinks_mutex_);
+        std::vector<std::shared_ptr<LogSink>> sinks(*sinks_);
+        auto it = std::find(sinks.begin(), sinks.end(), sink);
+        if (it == sinks.end()) return;
+        sinks.erase(it);
+        publish_sinks_(std::move(sinks));
+    }
+    // Threads that have not moved to the new list yet may still hold the sink, so its file is closed here instead of on release
+    sink->close();
+}
+
+std::shared_ptr<ConsoleSink> Logger::get_console_sink() noexcept{
+    return console_sink_;
+}
+
+std::shared_ptr<FileSink> Logger::get_file_sink() noexcept{
+    return file_sink_;
+}
+
+void Logger::enable_async(std::size_t capacity, enumOverflowPolicy policy){
+    if (is_async_enabled_.load(std::memory_order_acquire)){
+        error_handler_("Asynchronous logging is already enabled.");
+        return;
+    }
+    if (capacity == 0){
+        error_handler_("Asynchronous queue capacity cannot be zero.");
+        return;
+    }
+
+    register_exit_handler_();
+
+    async_capacity_.store(capacity, std::memory_order_relaxed);
+    async_overflow_policy_ = policy;
+    async_stop_requested_.store(false, std::memory_order_release);
+    async_writer_ = std::thread(async_writer_loop_);
+    is_async_enabled_.store(true, std::memory_order_release);
+}
+
+bool Logger::stop_async_(int64_t deadline_ns){
+    if (!is_async_enabled_.exchange(false, std::memory_order_seq_cst)) return true;
+
+    async_drain_deadline_ns_.store(deadline_ns, std::memory_order_relaxed);
+    async_stop_requested_.store(true, std::memory_order_release);
+    if (async_writer_.joinable()) async_writer_.join();
+
+    // Producers that have observed the enabled flag just before it was cleared finish their push first. They see the cleared
+    // flag on their next retry, so this does not wait for full buffers.
+    std::vector<std::shared_ptr<structThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(thread_buffers_mutex_);
+        buffers = thread_buffers_;
+    }
+    for (const auto &buffer: buffers){
+        while (buffer->in_flight.load(std::memory_order_seq_cst) > 0) std::this_thread::yield();
+    }
+
+    // Write messages of those producers
+    drain_async_queue_(deadline_ns);
+    commit_sinks_(true);
+    async_drain_deadline_ns_.store(INT64_MAX, std::memory_order_relaxed);
+    return deadline_ns == INT64_MAX || steady_now_ns() < deadline_ns;
+}
+
+void Logger::disable_async(){
+    stop_async_(INT64_MAX);
+}
+
+bool Logger::shutdown(uint32_t timeout_ms){
+    stop_config_watch_();
+    bool is_drained = stop_async_(steady_now_ns() + (int64_t) timeout_ms * 1000000);
+    flush();
+    stop_housekeeping_();
+    return is_drained;
+}
+
+void Logger::set_crash_handler(bool enabled){
+    if (is_crash_handler_enabled_.exchange(enabled) == enabled) return;
+
+    for (std::size_t i=0; i<sizeof(crash_signals) / sizeof(crash_signals[0]); i++){
+        if (!enabled){
+            restore_crash_handler(i);
+            continue;
+        }
+        #if defined(PLATFORM_WINDOWS)
+            previous_crash_handlers[i] = std::signal(crash_signals[i], crash_handler_);
+        #else
+            struct sigaction action;
+            std::memset(&action, 0, sizeof(action));
+            action.sa_handler = crash_handler_;
+            sigemptyset(&action.sa_mask);
+            sigaction(crash_signals[i], &action, &previous_crash_actions[i]);
+        #endif
+    }
+}
+
+void Logger::crash_handler_(int sig){
+    // Only the first crashing thread flushes. Other crashing threads wait, since their default action would end the process during the flush.
+    static std::atomic<bool> is_handling{false};
+    if (!is_handling.exchange(true)){
+        is_crash_handling_thread = true;
+        // Queued messages are not formatted yet, so they can only be written by the writer thread
+        if (is_async_enabled_.load(std::memory_order_acquire) && !is_writer_thread){
+            crash_flush_requested_.store(true, std::memory_order_release);
+            for (int i=0; i<DEFAULT_CRASH_DRAIN_TIMEOUT_MS && !crash_flush_done_.load(std::memory_order_acquire); i++) crash_sleep_1ms();
+        }
+        // Cache of the thread is not used, since loading the shared list takes a lock
+        for (const auto &sink: *current_sinks_.load(std::memory_order_acquire)) sink->flush_on_crash();
+        binary_file_.flush_on_crash();
+    }
+    else if (!is_crash_handling_thread){
+        wait_for_crash_exit();
+    }
+
+    for (std::size_t i=0; i<sizeof(crash_signals) / sizeof(crash_signals[0]); i++){
+        if (crash_signals[i] == sig) restore_crash_handler(i);
+    }
+    std::raise(sig);
+}
+
+bool Logger::is_async_enabled() noexcept{
+    return is_async_enabled_.load(std::memory_order_acquire);
+}
+
+void Logger::set_max_message_size(std::size_t size) noexcept{
+    LogRecord::max_size_.store((size > 0)? std::max<std::size_t>(size, DEFAULT_RECORD_BUFFER_SIZE): 0, std::memory_order_relaxed);
+}
+
+structLoggerStats Logger::stats(){
+    structLoggerStats stats;
+    LogStats::collect(stats);
+    stats.console_bytes = console_sink_->get_bytes_written();
+    stats.file_bytes = file_sink_->get_bytes_written();
+    stats.binary_bytes = binary_bytes_written_.load(std::memory_order_relaxed);
+    stats.dropped_count = async_dropped_counter_.load(std::memory_order_relaxed);
+    stats.error_count = err_counter_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+uint64_t Logger::get_dropped_count() noexcept{
+    return async_dropped_counter_.load(std::memory_order_relaxed);
+}
+
+void Logger::set_flush_policy(enumFlushPolicy policy, uint64_t threshold){
+    file_sink_->set_flush_policy(policy, threshold);
+}
+
+void Logger::set_file_buffer_size(std::size_t size){
+    file_sink_->set_buffer_size(size);
+}
+
+void Logger::set_file_segment_size(std::size_t segment_size){
+    if (!file_sink_->set_segment_size(segment_size)) error_handler_("Memory-mapped log file cannot be used.");
+}
+
+void Logger::set_rotation(const structRotationPolicy &policy){
+    file_sink_->set_rotation(policy);
+}
+
+void Logger::set_batch_policy(uint32_t max_records, uint64_t max_latency_us){
+    LogSink::set_batch_policy(max_records, max_latency_us);
+
+    if (max_records <= 1){
+        commit_sinks_(true);
+        return;
+    }
+    // Housekeeping thread writes batches of idle sinks when no further record arrives
+    std::lock_guard<std::mutex> lock(housekeeping_mutex_);
+    if (max_latency_us > 0) start_housekeeping_();
+    is_housekeeping_wake_requested_ = true;
+    housekeeping_cv_.notify_one();
+}
+
+void Logger::flush(){
+    if (is_duplicate_suppression_enabled_.load(std::memory_order_relaxed)) flush_repeat_summaries_(true);
+
+    for (const auto &sink: get_sinks_()) sink->flush();
+
+    std::lock_guard<std::mutex> lock(binary_mutex_);
+    if (!binary_file_.flush()) error_handler_("Binary log file cannot be flushed.");
+}
+
+void Logger::set_duplicate_suppression(bool enabled, uint32_t interval_ms){
+    duplicate_interval_ms_.store(interval_ms, std::memory_order_relaxed);
+    bool was_enabled = is_duplicate_suppression_enabled_.exchange(enabled, std::memory_order_relaxed);
+    if (enabled){
+        // Housekeeping thread writes summaries of call sites that stop repeating
+        if (interval_ms == 0) return;
+        std::lock_guard<std::mutex> lock(housekeeping_mutex_);
+        start_housekeeping_();
+        is_housekeeping_wake_requested_ = true;
+        housekeeping_cv_.notify_one();
+        return;
+    }
+
+    // Repeats counted so far are reported, otherwise they would never be written
+    if (was_enabled) flush_repeat_summaries_(true);
+}
+
+void Logger::set_log_threshold(enumLogLevel level){
+    std::lock_guard<std::mutex> lock(categories_mutex);
+    {
+        std::lock_guard<std::mutex> settings_lock(settings_mutex_);
+        structLogSettings settings = *settings_.load(std::memory_order_relaxed);
+        settings.level_threshold = (int) level;
+        publish_settings_(settings);
+    }
+    resolve_category_levels_();
+}
+
+void Logger::resolve_category_levels_() noexcept{
+    int threshold = get_settings()->level_threshold;
+    for (auto &entry: categories){
+        structCategoryNode &node = *entry.second;
+        int level = node.own_level;
+        if (level == LOGGER_CATEGORY_INHERIT_LEVEL) level = (node.parent != nullptr)? node.parent->level.load(std::memory_order_relaxed): threshold;
+        node.level.store(level, std::memory_order_relaxed);
+    }
+}
+
+LogCategory Logger::get(std::string_view name){
+    std::lock_guard<std::mutex> lock(categories_mutex);
+    auto it = categories.find(name);
+    if (it != categories.end()) return LogCategory(it->second.get());
+
+    // Missing parents are created as well (e.g. "net" and "net.tcp" for "net.tcp.rx")
+    structCategoryNode *parent = nullptr;
+    std::size_t end = 0;
+    do{
+        end = name.find('.', end + (parent != nullptr));
+        if (end == std::string_view::npos) end = name.size();
+        std::unique_ptr<structCategoryNode> &node = categories.emplace(name.substr(0, end), nullptr).first->second;
+        if (!node){
+            node.reset(new structCategoryNode);
+            node->name = std::string(name.substr(0, end));
+            node->parent = parent;
+            node->level.store((parent != nullptr)? parent->level.load(std::memory_order_relaxed): get_settings()->level_threshold,
+                              std::memory_order_relaxed);
+        }
+        parent = node.get();
+    } while (end < name.size());
+    return LogCategory(parent);
+}
+
+void Logger::set_category_level(std::string_view name, enumLogLevel level){
+    get(name);
+    std::lock_guard<std::mutex> lock(categories_mutex);
+    categories.find(name)->second->own_level = (int) level;
+    resolve_category_levels_();
+}
+
+void Logger::reset_category_level(std::string_view name){
+    std::lock_guard<std::mutex> lock(categories_mutex);
+    auto it = categories.find(name);
+    if (it == categories.end()) return;
+    it->second->own_level = LOGGER_CATEGORY_INHERIT_LEVEL;
+    resolve_category_levels_();
+}
+
+enumLogLevel Logger::get_log_threshold() noexcept{
+    return (enumLogLevel) get_settings()->level_threshold;
+}
+
+void Logger::set_binary_output(const std::string &filename, const std::string file_dir){
+    if (filename.empty()){
+        error_handler_("Filename is empty.");
+        return;
+    }
+
+    std::string path = normalize_dir(file_dir) + filename;
+
+    std::lock_guard<std::mutex> lock(binary_mutex_);
+    if (!binary_file_.open(path, true)){
+        error_handler_("The binary log file cannot be opened.");
+        return;
+    }
+
+    std::string header(BINARY_LOG_MAGIC);
+    append_binary(header, (uint16_t) BINARY_LOG_VERSION);
+    append_binary(header, (uint32_t) BINARY_LOG_BYTE_ORDER_MARK);
+    binary_file_.write(header.data(), header.size());
+
+    binary_sites_written_.assign(binary_sites_written_.size(), false);
+    is_binary_enabled_.store(true, std::memory_order_release);
+}
+
+uint32_t Logger::register_call_site(const structCallSite &site) noexcept{
+    (void) site;
+    return call_site_counter_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string Logger::format(const structLogMsg &msg_log){
+    std::string out;
+    ((msg_log.settings != nullptr)? msg_log.settings: get_settings())->formatter->format(msg_log, out);
+    return out;
+}
+
+void Logger::set_format(const structLogFormat &fmt){
+    set_format_(fmt);
 }
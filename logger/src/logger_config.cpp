@@ -0,0 +1,242 @@
+#include <logger_config.h>
+
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <charconv>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+using namespace logger;
+
+namespace{
+
+    std::string trim(const std::string &s){
+        std::size_t begin = s.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return "";
+        std::size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    std::string to_lower(std::string s){
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return (char) std::tolower(c); });
+        return s;
+    }
+
+    // Removes the comment of the line. '#' starts a comment at the beginning or after a space, outside of quotes.
+    std::string strip_comment(const std::string &line){
+        char quote = 0;
+        for (std::size_t i=0; i<line.size(); i++){
+            char c = line[i];
+            if (quote != 0){
+                if (c == '\\' && quote == '"') i++;
+                else if (c == quote) quote = 0;
+            }
+            else if (c == '"' || c == '\''){
+                quote = c;
+            }
+            else if (c == '#' && (i == 0 || line[i-1] == ' ' || line[i-1] == '\t')){
+                return line.substr(0, i);
+            }
+        }
+        return line;
+    }
+
+    bool unquote(const std::string &value, std::string &out){
+        if (value.size() < 2 || (value.front() != '"' && value.front() != '\'')){
+            out = value;
+            return true;
+        }
+        if (value.back() != value.front()) return false;
+
+        out.clear();
+        for (std::size_t i=1; i+1<value.size(); i++){
+            char c = value[i];
+            if (value.front() == '"' && c == '\\' && i+2 < value.size()){
+                c = value[++i];
+                if (c == 't') c = '\t';
+                else if (c == 'n') c = '\n';
+            }
+            else if (value.front() == '\'' && c == '\'' && value[i+1] == '\''){
+                i++;
+            }
+            out.push_back(c);
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool parse_number(const std::string &value, T &out){
+        auto r = std::from_chars(value.data(), value.data() + value.size(), out);
+        return r.ec == std::errc() && r.ptr == value.data() + value.size();
+    }
+
+    bool parse_bool(const std::string &value, bool &out){
+        std::string v = to_lower(value);
+        if (v == "true" || v == "yes" || v == "on"){ out = true; return true; }
+        if (v == "false" || v == "no" || v == "off"){ out = false; return true; }
+        return false;
+    }
+
+    bool parse_level(const std::string &value, enumLogLevel &out){
+        static const std::pair<const char*, enumLogLevel> levels[] = {
+            {"fatal", enumLogLevel::FATAL_}, {"error", enumLogLevel::ERROR_}, {"alert", enumLogLevel::ALERT_},
+            {"warning", enumLogLevel::WARNING_}, {"info", enumLogLevel::INFO_}, {"debug", enumLogLevel::DEBUG_},
+            {"trace", enumLogLevel::TRACE_}
+        };
+        std::string v = to_lower(value);
+        for (const auto &level: levels){
+            if (v == level.first){ out = level.second; return true; }
+        }
+        return false;
+    }
+
+    bool parse_delimiter(const std::string &value, enumDelimiterType &out){
+        std::string v = to_lower(value);
+        if (v == "tab") out = enumDelimiterType::TAB;
+        else if (v == "space") out = enumDelimiterType::SPACE;
+        else if (v == "comma") out = enumDelimiterType::COMMA;
+        else if (v == "dash") out = enumDelimiterType::DASH;
+        else return false;
+        return true;
+    }
+
+    bool parse_output(const std::string &value, enumOutputFormat &out){
+        std::string v = to_lower(value);
+        if (v == "text") out = enumOutputFormat::TEXT;
+        else if (v == "json") out = enumOutputFormat::JSON;
+        else return false;
+        return true;
+    }
+
+    bool parse_flush_policy(const std::string &value, enumFlushPolicy &out){
+        std::string v = to_lower(value);
+        if (v == "always") out = enumFlushPolicy::ALWAYS;
+        else if (v == "every_n_bytes") out = enumFlushPolicy::EVERY_N_BYTES;
+        else if (v == "every_n_ms") out = enumFlushPolicy::EVERY_N_MS;
+        else if (v == "on_error") out = enumFlushPolicy::ON_ERROR;
+        else return false;
+        return true;
+    }
+
+    // Bit of each dotted key in structLogConfig::keys
+    const std::pair<const char*, uint32_t> config_keys[] = {
+        {"level", CONFIG_KEY_LEVEL},
+        {"source", CONFIG_KEY_SOURCE},
+        {"colors", CONFIG_KEY_COLORS},
+        {"format.timestamp", CONFIG_KEY_FORMAT_TIMESTAMP},
+        {"format.delimiter", CONFIG_KEY_FORMAT_DELIMITER},
+        {"format.output", CONFIG_KEY_FORMAT_OUTPUT},
+        {"format.padding", CONFIG_KEY_FORMAT_PADDING},
+        {"file.name", CONFIG_KEY_FILE_NAME},
+        {"file.dir", CONFIG_KEY_FILE_DIR},
+        {"file.timestamp_prefix", CONFIG_KEY_FILE_TIMESTAMP_PREFIX},
+        {"file.flush_policy", CONFIG_KEY_FLUSH_POLICY},
+        {"file.flush_threshold", CONFIG_KEY_FLUSH_THRESHOLD},
+        {"file.buffer_size", CONFIG_KEY_FILE_BUFFER_SIZE},
+        {"batch.max_records", CONFIG_KEY_BATCH_MAX_RECORDS},
+        {"batch.max_latency_us", CONFIG_KEY_BATCH_MAX_LATENCY_US}
+    };
+
+    // Sets the value of a dotted key (e.g. "format.timestamp") to the config
+    bool apply_entry(const std::string &key, const std::string &value, structLogConfig &config){
+        if (key == "level") return parse_level(value, config.level_threshold);
+        if (key == "source") return parse_bool(value, config.is_source_enabled);
+        if (key == "colors") return parse_bool(value, config.is_colors_enabled);
+        if (key == "format.timestamp"){ config.format.fmt_timestamp = value; return true; }
+        if (key == "format.delimiter") return parse_delimiter(value, config.format.fmt_delimiter_type);
+        if (key == "format.output") return parse_output(value, config.format.fmt_output);
+        if (key == "format.padding"){
+            int padding;
+            if (!parse_number(value, padding) || padding < 0 || padding > 8) return false;
+            config.format.fmt_padding_size = (enumPaddingSize) padding;
+            return true;
+        }
+        if (key == "file.name"){ config.output_filename = value; return true; }
+        if (key == "file.dir"){ config.output_dir = value; return true; }
+        if (key == "file.timestamp_prefix") return parse_bool(value, config.is_timestamp_prefix_enabled);
+        if (key == "file.flush_policy") return parse_flush_policy(value, config.flush_policy);
+        if (key == "file.flush_threshold") return parse_number(value, config.flush_threshold);
+        if (key == "file.buffer_size") return parse_number(value, config.file_buffer_size);
+        if (key == "batch.max_records") return parse_number(value, config.batch_max_records);
+        if (key == "batch.max_latency_us") return parse_number(value, config.batch_max_latency_us);
+        return false;
+    }
+}
+
+/*********************************************************************
+ *
+ * Public Functions
+ *
+*********************************************************************/
+
+bool logger::parse_config(const std::string &text, structLogConfig &config, std::string &error){
+    structLogConfig parsed;
+    std::vector<std::pair<std::size_t, std::string>> sections;     // Indentation and key of enclosing sections
+    std::istringstream input(text);
+    std::string raw_line;
+    int line_number = 0;
+
+    while (std::getline(input, raw_line)){
+        line_number++;
+        std::string line = strip_comment(raw_line);
+        if (trim(line).empty() || trim(line) == "---") continue;
+
+        std::size_t indent = line.find_first_not_of(' ');
+        if (line[indent] == '\t'){
+            error = "Line " + std::to_string(line_number) + " is indented with tab.";
+            return false;
+        }
+        std::size_t colon = line.find(':', indent);
+        if (colon == std::string::npos){
+            error = "Line " + std::to_string(line_number) + " is not a \"key: value\" pair.";
+            return false;
+        }
+
+        while (!sections.empty() && sections.back().first >= indent) sections.pop_back();
+        std::string key = trim(line.substr(indent, colon - indent));
+        std::string value;
+        if (!unquote(trim(line.substr(colon + 1)), value)){
+            error = "Line " + std::to_string(line_number) + " has an unterminated quote.";
+            return false;
+        }
+
+        std::string full_key;
+        for (const auto &section: sections) full_key += section.second + ".";
+        full_key += key;
+
+        if (trim(line.substr(colon + 1)).empty()){
+            sections.emplace_back(indent, key);
+            continue;
+        }
+        if (!apply_entry(full_key, value, parsed)){
+            error = "Line " + std::to_string(line_number) + " has an unknown key or invalid value: " + full_key;
+            return false;
+        }
+        for (const auto &config_key: config_keys){
+            if (full_key == config_key.first) parsed.keys |= config_key.second;
+        }
+    }
+
+    config = parsed;
+    return true;
+}
+
+bool logger::read_config_file(const std::string &file_path, structLogConfig &config, std::string &error){
+    std::string extension = file_path.substr(std::min(file_path.size(), file_path.find_last_of('.')));
+    if (extension != ".yaml" && extension != ".yml"){
+        error = "Configuration file must be in YAML format: " + file_path;
+        return false;
+    }
+
+    std::ifstream file(file_path);
+    if (!file.is_open()){
+        error = "Configuration file cannot be opened: " + file_path;
+        return false;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    return parse_config(content.str(), config, error);
+}
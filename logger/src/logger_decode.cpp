@@ -0,0 +1,106 @@
+#include <logger_decode.h>
+
+#include <unordered_map>
+
+#include <logger.h>
+
+using namespace logger;
+
+namespace{
+
+    /**
+     * @struct structDecodedSite
+     *
+     * @brief This struct keeps a call site read from the binary log file
+    */
+    struct structDecodedSite{
+        enumLogLevel log_level;
+        std::string file;
+        int line;
+        std::string fmt;
+        std::string source;                 ///< Source field as "basename:line"
+        structSourceLocation location;      ///< Location that refers to the source field
+    };
+
+    bool decode_string(const std::string &data, std::size_t &pos, std::string &out){
+        uint32_t len;
+        if (!read_binary(data.data(), data.size(), pos, len) || pos + len > data.size()) return false;
+        out.assign(data, pos, len);
+        pos += len;
+        return true;
+    }
+
+    bool decode_call_site(const std::string &data, std::size_t &pos, std::unordered_map<uint32_t, structDecodedSite> &sites){
+        uint32_t site_id;
+        uint8_t log_level;
+        int32_t line;
+        structDecodedSite site;
+        if (!read_binary(data.data(), data.size(), pos, site_id)) return false;
+        if (!read_binary(data.data(), data.size(), pos, log_level)) return false;
+        if (!read_binary(data.data(), data.size(), pos, line)) return false;
+        if (!decode_string(data, pos, site.file) || !decode_string(data, pos, site.fmt)) return false;
+
+        site.log_level = (enumLogLevel) log_level;
+        site.line = line;
+        site.source = std::string(source_basename(site.file.c_str())) + ":" + std::to_string(line);
+
+        // Location refers to the strings of the stored site, which keeps its address in the map
+        structDecodedSite &stored = sites[site_id] = std::move(site);
+        stored.location = {stored.file.c_str(), stored.line, stored.source.data(), (uint32_t) stored.source.size()};
+        return true;
+    }
+
+    bool decode_record(const std::string &data, std::size_t &pos, const std::unordered_map<uint32_t, structDecodedSite> &sites, std::string &out){
+        uint32_t site_id;
+        int64_t ts_ns;
+        uint8_t flags;
+        uint32_t payload_len;
+        if (!read_binary(data.data(), data.size(), pos, site_id)) return false;
+        if (!read_binary(data.data(), data.size(), pos, ts_ns)) return false;
+        if (!read_binary(data.data(), data.size(), pos, flags)) return false;
+        if (!read_binary(data.data(), data.size(), pos, payload_len) || pos + payload_len > data.size()) return false;
+
+        auto it = sites.find(site_id);
+        if (it == sites.end()) return false;
+        const structDecodedSite &site = it->second;
+
+        structLogMsg log;
+        get_timestamp_struct(std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ts_ns))), log.timestamp);
+        log.log_level = site.log_level;
+        log.source = (flags & BINARY_FLAG_SOURCE_ENABLED)? &site.location: nullptr;
+        if (!format_binary_args(site.fmt.c_str(), data.data() + pos, payload_len, log.msg)) return false;
+        pos += payload_len;
+
+        out += Logger::format(log);
+        return true;
+    }
+}
+
+bool logger::decode_binary_header(const std::string &data, std::size_t &pos){
+    std::string magic(BINARY_LOG_MAGIC);
+    if (data.compare(0, magic.size(), magic) != 0) return false;
+    pos = magic.size();
+
+    uint16_t version;
+    uint32_t byte_order_mark;
+    if (!read_binary(data.data(), data.size(), pos, version) || version != BINARY_LOG_VERSION) return false;
+    if (!read_binary(data.data(), data.size(), pos, byte_order_mark) || byte_order_mark != BINARY_LOG_BYTE_ORDER_MARK) return false;
+    return true;
+}
+
+bool logger::decode_binary_entries(const std::string &data, std::size_t &pos, std::string &out){
+    std::unordered_map<uint32_t, structDecodedSite> sites;
+    while (pos < data.size()){
+        // Position is left at the start of the entry that cannot be decoded
+        std::size_t entry_pos = pos;
+        char kind = data[pos++];
+        bool is_valid = false;
+        if (kind == BINARY_ENTRY_CALL_SITE) is_valid = decode_call_site(data, pos, sites);
+        else if (kind == BINARY_ENTRY_RECORD) is_valid = decode_record(data, pos, sites, out);
+        if (!is_valid){
+            pos = entry_pos;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,285 @@
+#include <logger_file.h>
+#include <logger_defs.h>
+
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined(PLATFORM_WINDOWS)
+    #include <io.h>
+    #define LOGGER_OPEN(path, flags)        _open(path, (flags) | _O_BINARY, _S_IREAD | _S_IWRITE)
+    #define LOGGER_WRITE(fd, data, size)    _write(fd, data, (unsigned int) (size))
+    #define LOGGER_CLOSE(fd)                _close(fd)
+    #define LOGGER_SEEK_END(fd)             _lseeki64(fd, 0, SEEK_END)
+    #define LOGGER_SEEK_SET(fd, offset)     _lseeki64(fd, (__int64) (offset), SEEK_SET)
+    #define LOGGER_TRUNCATE(fd, size)       _chsize_s(fd, (__int64) (size))
+    #define LOGGER_O_APPEND                 _O_APPEND
+    #define LOGGER_O_TRUNC                  _O_TRUNC
+    #define LOGGER_O_CREAT_WRONLY           (_O_CREAT | _O_WRONLY)
+    #define LOGGER_O_CREAT_RDWR             (_O_CREAT | _O_RDWR)
+#else
+    #include <unistd.h>
+    #include <cerrno>
+    #include <sys/mman.h>
+    #include <sys/uio.h>
+    #define LOGGER_OPEN(path, flags)        ::open(path, flags, 0644)
+    #define LOGGER_WRITE(fd, data, size)    ::write(fd, data, size)
+    #define LOGGER_CLOSE(fd)                ::close(fd)
+    #define LOGGER_SEEK_END(fd)             ::lseek(fd, 0, SEEK_END)
+    #define LOGGER_SEEK_SET(fd, offset)     ::lseek(fd, (off_t) (offset), SEEK_SET)
+    #define LOGGER_TRUNCATE(fd, size)       ::ftruncate(fd, (off_t) (size))
+    #define LOGGER_O_APPEND                 O_APPEND
+    #define LOGGER_O_TRUNC                  O_TRUNC
+    #define LOGGER_O_CREAT_WRONLY           (O_CREAT | O_WRONLY)
+    #define LOGGER_O_CREAT_RDWR             (O_CREAT | O_RDWR)
+#endif
+
+using namespace logger;
+
+/*********************************************************************
+ *
+ * Private Functions
+ *
+*********************************************************************/
+
+bool LogFile::write_fd_(const char *data, std::size_t size){
+    while (size > 0){
+        auto r = LOGGER_WRITE(fd_, data, size);
+        if (r < 0){
+            #if !defined(PLATFORM_WINDOWS)
+                if (errno == EINTR) continue;
+            #endif
+            return false;
+        }
+        data += r;
+        size -= (std::size_t) r;
+    }
+    return true;
+}
+
+bool LogFile::map_segment_(uint64_t offset){
+    unmap_segment_();
+    #if defined(PLATFORM_WINDOWS)
+        (void) offset;
+        return false;
+    #else
+        // Segments are aligned to their size, which is a multiple of the page size
+        uint64_t start = offset - offset % segment_size_;
+
+        // On Linux, blocks of the segment are reserved up front, so writing to the mapping does not fail on a full disk.
+        // If the disk is already full, the segment is not mapped and the caller writes through the buffer instead.
+        #if defined(PLATFORM_LINUX)
+            int err = ::posix_fallocate(fd_, (off_t) start, (off_t) segment_size_);
+            if (err != 0 && err != EOPNOTSUPP && err != EINVAL) return false;
+            // File system cannot reserve blocks, so the file is only extended
+            if (err != 0 && LOGGER_TRUNCATE(fd_, start + segment_size_) != 0) return false;
+        #else
+            // File is only extended, and its blocks are allocated when the pages are written back.
+            // Writing to the mapping raises SIGBUS if the disk becomes full meanwhile.
+            if (LOGGER_TRUNCATE(fd_, start + segment_size_) != 0) return false;
+        #endif
+
+        void *addr = ::mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, (off_t) start);
+        if (addr == MAP_FAILED) return false;
+
+        segment_ = static_cast<char*>(addr);
+        segment_offset_ = start;
+        segment_used_ = (std::size_t) (offset - start);
+        return true;
+    #endif
+}
+
+bool LogFile::fall_back_to_buffer_(){
+    // Space reserved after the written data is released, and the rest is appended at the end of the data
+    unmap_segment_();
+    segment_size_ = 0;
+    if (LOGGER_TRUNCATE(fd_, file_size_) != 0) return false;
+    return LOGGER_SEEK_SET(fd_, file_size_) >= 0;
+}
+
+void LogFile::unmap_segment_(){
+    if (segment_ == nullptr) return;
+    #if !defined(PLATFORM_WINDOWS)
+        ::munmap(segment_, segment_size_);
+    #endif
+    segment_ = nullptr;
+}
+
+/*********************************************************************
+ *
+ * Public Functions
+ *
+*********************************************************************/
+
+LogFile::LogFile(std::size_t buffer_size): LogFile(buffer_size, -1){
+    is_owned_ = true;
+}
+
+LogFile::LogFile(std::size_t buffer_size, int fd):
+    fd_(fd),
+    is_owned_(false),
+    buffer_(buffer_size > 0? new char[buffer_size]: nullptr),
+    capacity_(buffer_size),
+    used_(0),
+    file_size_(0),
+    segment_size_(0),
+    segment_(nullptr),
+    segment_offset_(0),
+    segment_used_(0){
+}
+
+LogFile::~LogFile(){
+    close();
+}
+
+bool LogFile::open(const std::string &path, bool truncate){
+    close();
+
+    int flags = LOGGER_O_CREAT_WRONLY | (truncate? LOGGER_O_TRUNC: LOGGER_O_APPEND);
+    // Mapped pages must be readable, and data is placed by offset instead of appended
+    if (segment_size_ > 0) flags = LOGGER_O_CREAT_RDWR | (truncate? LOGGER_O_TRUNC: 0);
+    fd_ = LOGGER_OPEN(path.c_str(), flags);
+    if (fd_ < 0) return false;
+
+    // Size of the existing content is taken once, then it is tracked by write()
+    auto end = truncate? 0: LOGGER_SEEK_END(fd_);
+    file_size_ = (end > 0)? (uint64_t) end: 0;
+
+    if (segment_size_ > 0 && !map_segment_(file_size_)){
+        LOGGER_CLOSE(fd_);
+        fd_ = -1;
+        file_size_ = 0;
+        return false;
+    }
+    path_ = path;
+    return true;
+}
+
+void LogFile::close(){
+    if (fd_ < 0) return;
+
+    flush();
+    if (segment_size_ > 0){
+        // Preallocated space after the last record is released
+        unmap_segment_();
+        LOGGER_TRUNCATE(fd_, file_size_);
+    }
+    if (is_owned_) LOGGER_CLOSE(fd_);
+    fd_ = -1;
+    file_size_ = 0;
+    path_.clear();
+}
+
+bool LogFile::is_open() const noexcept{
+    return fd_ >= 0;
+}
+
+bool LogFile::write(const char *data, std::size_t size){
+    if (fd_ < 0) return false;
+
+    while (segment_size_ > 0 && size > 0){
+        if (segment_ == nullptr || segment_used_ == segment_size_){
+            if (!map_segment_(file_size_) && !fall_back_to_buffer_()) return false;
+            if (segment_size_ == 0) break;
+        }
+        std::size_t chunk = std::min(size, segment_size_ - segment_used_);
+        std::memcpy(segment_ + segment_used_, data, chunk);
+        segment_used_ += chunk;
+        file_size_ += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+    if (size == 0) return true;
+
+    file_size_ += size;
+    if (used_ + size <= capacity_){
+        std::memcpy(buffer_.get() + used_, data, size);
+        used_ += size;
+        return true;
+    }
+
+    // Buffer cannot hold the data, so pending bytes and the data are written together
+    #if !defined(PLATFORM_WINDOWS)
+        if (used_ > 0){
+            struct iovec iov[2] = {{buffer_.get(), used_}, {const_cast<char*>(data), size}};
+            std::size_t pending = used_;
+            used_ = 0;
+            ssize_t r;
+            do{
+                r = ::writev(fd_, iov, 2);
+            } while (r < 0 && errno == EINTR);
+            if (r < 0) return false;
+
+            // Partially written parts are completed with plain writes
+            std::size_t written = (std::size_t) r;
+            if (written < pending) return write_fd_(buffer_.get() + written, pending - written) && write_fd_(data, size);
+            written -= pending;
+            return write_fd_(data + written, size - written);
+        }
+    #endif
+    if (!flush()) return false;
+    if (size <= capacity_){
+        std::memcpy(buffer_.get(), data, size);
+        used_ = size;
+        return true;
+    }
+    return write_fd_(data, size);
+}
+
+bool LogFile::flush(){
+    // Mapped data is already in the page cache, and the kernel writes it back
+    if (fd_ < 0 || used_ == 0) return true;
+
+    bool r = write_fd_(buffer_.get(), used_);
+    used_ = 0;
+    return r;
+}
+
+void LogFile::flush_on_crash() noexcept{
+    if (fd_ < 0) return;
+
+    if (used_ > 0){
+        write_fd_(buffer_.get(), used_);
+        used_ = 0;
+    }
+    // Reserved space after the written data would otherwise be left as zeros
+    if (segment_size_ > 0) LOGGER_TRUNCATE(fd_, file_size_);
+}
+
+void LogFile::set_buffer_size(std::size_t buffer_size){
+    flush();
+    buffer_.reset(buffer_size > 0? new char[buffer_size]: nullptr);
+    capacity_ = buffer_size;
+    used_ = 0;
+}
+
+bool LogFile::set_segment_size(std::size_t segment_size){
+    #if defined(PLATFORM_WINDOWS)
+        return segment_size == 0;
+    #else
+        std::string path = path_;
+        bool was_open = is_open();
+        close();
+
+        std::size_t page_size = (std::size_t) ::sysconf(_SC_PAGESIZE);
+        segment_size_ = (segment_size + page_size - 1) / page_size * page_size;
+        return !was_open || open(path);
+    #endif
+}
+
+bool LogFile::is_mapped() const noexcept{
+    return segment_size_ > 0;
+}
+
+std::size_t LogFile::buffered_size() const noexcept{
+    return used_;
+}
+
+uint64_t LogFile::file_size() const noexcept{
+    return file_size_;
+}
+
+const std::string &LogFile::path() const noexcept{
+    return path_;
+}
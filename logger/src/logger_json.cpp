@@ -0,0 +1,83 @@
+#include <logger_json.h>
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define LOGGER_JSON_SSE2
+#endif
+
+using namespace logger;
+
+namespace{
+
+    inline bool needs_escape(unsigned char c){
+        return c < 0x20 || c == '"' || c == '\\';
+    }
+
+    // Returns the number of leading bytes that can be copied without escaping
+    std::size_t count_plain(const char *data, std::size_t size){
+        std::size_t i = 0;
+        #if defined(LOGGER_JSON_SSE2)
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i control_max = _mm_set1_epi8(0x1F);
+            for (; i + 16 <= size; i += 16){
+                __m128i v = _mm_loadu_si128((const __m128i*) (data + i));
+                // Unsigned v <= 0x1F is max(v, 0x1F) == 0x1F
+                __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                               _mm_cmpeq_epi8(_mm_max_epu8(v, control_max), control_max));
+                int mask = _mm_movemask_epi8(special);
+                if (mask != 0){
+                    #if defined(_MSC_VER)
+                        unsigned long bit;
+                        _BitScanForward(&bit, (unsigned long) mask);
+                        return i + bit;
+                    #else
+                        return i + (std::size_t) __builtin_ctz((unsigned) mask);
+                    #endif
+                }
+            }
+        #endif
+        while (i < size && !needs_escape((unsigned char) data[i])) i++;
+        return i;
+    }
+
+    void append_escape(std::string &out, unsigned char c){
+        static const char hex[] = "0123456789abcdef";
+        switch (c){
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default: {
+                char u[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0x0F]};
+                out.append(u, sizeof(u));
+            }
+        }
+    }
+}
+
+/*********************************************************************
+ *
+ * Public Functions
+ *
+*********************************************************************/
+
+void logger::append_json_string(std::string &out, std::string_view s){
+    out.push_back('"');
+    const char *data = s.data();
+    std::size_t size = s.size();
+    while (size > 0){
+        std::size_t plain = count_plain(data, size);
+        out.append(data, plain);
+        if (plain == size) break;
+        append_escape(out, (unsigned char) data[plain]);
+        data += plain + 1;
+        size -= plain + 1;
+    }
+    out.push_back('"');
+}
@@ -0,0 +1,77 @@
+#include <logger.h>
+
+#include <vector>
+
+using namespace logger;
+
+namespace{
+
+    // Set when the pool of the thread is destroyed, so records logged after it do not touch the pool
+    thread_local bool is_string_pool_released = false;
+
+    /**
+     * @struct structStringPool
+     *
+     * @brief This struct keeps heap strings of finished records of a thread
+    */
+    struct structStringPool{
+        std::vector<std::string> strings;
+
+        ~structStringPool(){
+            is_string_pool_released = true;
+        }
+    };
+
+    thread_local structStringPool string_pool;
+
+    // Strings that fit into the small string buffer have no heap storage to reuse
+    const std::size_t small_string_capacity = std::string().capacity();
+}
+
+/*********************************************************************
+ *
+ * Static Variables
+ *
+*********************************************************************/
+
+std::atomic<std::size_t> LogRecord::max_size_{DEFAULT_MAX_MESSAGE_SIZE};
+
+/*********************************************************************
+ *
+ * Private Functions
+ *
+*********************************************************************/
+
+void LogRecord::acquire_string_(std::string &s) noexcept{
+    if (is_string_pool_released || string_pool.strings.empty() || s.capacity() > small_string_capacity) return;
+    s.swap(string_pool.strings.back());
+    string_pool.strings.pop_back();
+}
+
+void LogRecord::release_string_(std::string &s) noexcept{
+    if (is_string_pool_released || s.capacity() <= small_string_capacity) return;
+    std::vector<std::string> &strings = string_pool.strings;
+    if (strings.capacity() == 0){
+        try{
+            strings.reserve(DEFAULT_RECORD_POOL_SIZE);
+        }
+        catch (const std::bad_alloc &){
+            return;
+        }
+    }
+    if (strings.size() >= DEFAULT_RECORD_POOL_SIZE) return;
+    s.clear();
+    strings.push_back(std::move(s));
+}
+
+/*********************************************************************
+ *
+ * Public Functions
+ *
+*********************************************************************/
+
+LogRecord::~LogRecord(){
+    if (is_active_) Logger::submit_record_(*this);
+    release_string_(overflow_);
+    release_string_(fields_);
+}
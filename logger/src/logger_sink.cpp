@@ -0,0 +1,638 @@
+#include <logger_sink.h>
+#include <logger.h>
+#include <logger_json.h>
+
+#include <ctime>
+#include <cstdio>
+#include <algorithm>
+#include <filesystem>
+
+#if defined(PLATFORM_WINDOWS)
+    #include <io.h>
+    #define LOGGER_STDOUT_FD    _fileno(stdout)
+    #define LOGGER_STDERR_FD    _fileno(stderr)
+    #define LOGGER_ISATTY(fd)   (_isatty(fd) != 0)
+#else
+    #include <unistd.h>
+    #define LOGGER_STDOUT_FD    fileno(stdout)
+    #define LOGGER_STDERR_FD    fileno(stderr)
+    #define LOGGER_ISATTY(fd)   (isatty(fd) != 0)
+#endif
+
+using namespace logger;
+
+/*********************************************************************
+ *
+ * Static Variables
+ *
+*********************************************************************/
+
+std::atomic<uint32_t> LogSink::batch_max_records_{DEFAULT_BATCH_MAX_RECORDS};
+std::atomic<uint64_t> LogSink::batch_max_latency_us_{DEFAULT_BATCH_MAX_LATENCY_US};
+
+/*********************************************************************
+ *
+ * LineFormatter
+ *
+*********************************************************************/
+
+LineFormatter::LineFormatter(const structLogFormat &fmt, const structLineLayout &layout):
+    fmt_(fmt),
+    timestamp_formatter_(fmt.fmt_timestamp),
+    layout_(layout){
+}
+
+void LineFormatter::format(const structLogMsg &msg_log, std::string &out) const{
+    if (fmt_.fmt_output == enumOutputFormat::JSON){
+        format_json_(msg_log, out);
+        return;
+    }
+
+    if (layout_.has_timestamp) timestamp_formatter_.format(msg_log.timestamp, out);
+    if (msg_log.log_level_desc.empty()){
+        std::size_t idx = (std::size_t) msg_log.log_level;
+        out += layout_.level_tags[(idx < LOG_LEVEL_COUNT)? idx: (std::size_t) enumLogLevel::INVALID_];
+    }
+    else{
+        if (layout_.has_timestamp) out += layout_.separator;
+        out += msg_log.log_level_desc;
+    }
+    if (!msg_log.category.empty()){
+        out += layout_.separator;
+        out.append(msg_log.category.data(), msg_log.category.size());
+    }
+    if (msg_log.source != nullptr){
+        out += layout_.separator;
+        out.append(msg_log.source->text, msg_log.source->text_size);
+    }
+    if (!msg_log.msg.empty()){
+        out += layout_.separator;
+        out += msg_log.msg;
+    }
+    for_each_field(msg_log.fields, [&](enumFieldKind, std::string_view key, std::string_view value){
+        out += layout_.separator;
+        out.append(key.data(), key.size());
+        out.push_back('=');
+        out.append(value.data(), value.size());
+    });
+    out += layout_.newline;
+}
+
+void LineFormatter::format_json_(const structLogMsg &msg_log, std::string &out) const{
+    out.push_back('{');
+    if (layout_.has_timestamp){
+        // Timestamp formats may contain any character, so it is escaped after rendering
+        thread_local std::string timestamp;
+        timestamp.clear();
+        timestamp_formatter_.format(msg_log.timestamp, timestamp);
+        out += "\"timestamp\":";
+        append_json_string(out, timestamp);
+        out.push_back(',');
+    }
+    out += "\"level\":";
+    if (msg_log.log_level_desc.empty()){
+        std::size_t idx = (std::size_t) msg_log.log_level;
+        append_json_string(out, layout_.level_names[(idx < LOG_LEVEL_COUNT)? idx: (std::size_t) enumLogLevel::INVALID_]);
+    }
+    else{
+        append_json_string(out, msg_log.log_level_desc);
+    }
+    if (!msg_log.category.empty()){
+        out += ",\"category\":";
+        append_json_string(out, msg_log.category);
+    }
+    if (msg_log.source != nullptr){
+        out += ",\"source\":";
+        append_json_string(out, std::string_view(msg_log.source->text, msg_log.source->text_size));
+    }
+    out += ",\"message\":";
+    append_json_string(out, msg_log.msg);
+    for_each_field(msg_log.fields, [&](enumFieldKind kind, std::string_view key, std::string_view value){
+        out.push_back(',');
+        append_json_string(out, key);
+        out.push_back(':');
+        if (kind == enumFieldKind::LITERAL) out.append(value.data(), value.size());
+        else append_json_string(out, value);
+    });
+    out.push_back('}');
+    out += layout_.newline;
+}
+
+const structLogFormat &LineFormatter::get_format() const noexcept{
+    return fmt_;
+}
+
+/*********************************************************************
+ *
+ * LogSink
+ *
+*********************************************************************/
+
+bool LogSink::add_to_batch_(structOutputBatch &batch){
+    if (++batch.records >= batch_max_records_.load(std::memory_order_relaxed)) return true;
+
+    uint64_t max_latency_us = batch_max_latency_us_.load(std::memory_order_relaxed);
+    if (max_latency_us == 0) return false;
+    auto now = std::chrono::steady_clock::now();
+    if (batch.records == 1){
+        batch.start = now;
+        return false;
+    }
+    return now - batch.start >= std::chrono::microseconds(max_latency_us);
+}
+
+bool LogSink::is_batch_due_(const structOutputBatch &batch, bool force){
+    if (batch.records == 0) return false;
+    if (force) return true;
+    uint64_t max_latency_us = batch_max_latency_us_.load(std::memory_order_relaxed);
+    return max_latency_us > 0 && std::chrono::steady_clock::now() - batch.start >= std::chrono::microseconds(max_latency_us);
+}
+
+LogSink::LogSink():
+    level_((int) enumLogLevel::TRACE_),
+    formatter_(nullptr),
+    bytes_written_(0){
+}
+
+void LogSink::set_level(enumLogLevel level) noexcept{
+    level_.store((int) level, std::memory_order_relaxed);
+}
+
+enumLogLevel LogSink::get_level() const noexcept{
+    return (enumLogLevel) level_.load(std::memory_order_relaxed);
+}
+
+void LogSink::set_format(const structLogFormat &fmt){
+    formatter_.store(Logger::intern_formatter_(fmt), std::memory_order_release);
+}
+
+void LogSink::reset_format() noexcept{
+    formatter_.store(nullptr, std::memory_order_release);
+}
+
+void LogSink::set_batch_policy(uint32_t max_records, uint64_t max_latency_us) noexcept{
+    batch_max_records_.store(std::max<uint32_t>(max_records, 1), std::memory_order_relaxed);
+    batch_max_latency_us_.store(max_latency_us, std::memory_order_relaxed);
+}
+
+uint32_t LogSink::get_batch_max_records() noexcept{
+    return batch_max_records_.load(std::memory_order_relaxed);
+}
+
+uint64_t LogSink::get_batch_max_latency_us() noexcept{
+    return batch_max_latency_us_.load(std::memory_order_relaxed);
+}
+
+/*********************************************************************
+ *
+ * ConsoleSink
+ *
+*********************************************************************/
+
+void ConsoleSink::flush_(){
+    // Output of the application through stdio is written first, so the order on the console is kept
+    std::fflush(stdout);
+    if (file_.buffered_size() > 0){
+        auto start = std::chrono::steady_clock::now();
+        file_.flush();
+        LogStats::add_flush((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    batch_.records = 0;
+}
+
+void ConsoleSink::append_line_(LogFile &file, bool is_tty, const structLogMsg &msg_log, const std::string &line){
+    // Negative value follows the colors of the logger settings the message is logged with
+    int colors = colors_.load(std::memory_order_relaxed);
+    bool is_colored = (colors < 0)? (msg_log.settings != nullptr && msg_log.settings->is_colors_enabled): colors != 0;
+    if (is_tty && is_colored){
+        const std::string &color = Logger::pick_log_color_(msg_log.log_level);
+        file.write(color.data(), color.size());
+        file.write(line.data(), line.size());
+        file.write(COLOR_RESET, sizeof(COLOR_RESET) - 1);
+        add_bytes_written_(color.size() + line.size() + sizeof(COLOR_RESET) - 1);
+    }
+    else{
+        file.write(line.data(), line.size());
+        add_bytes_written_(line.size());
+    }
+}
+
+ConsoleSink::ConsoleSink(): ConsoleSink(LOGGER_STDOUT_FD, LOGGER_STDERR_FD){
+}
+
+ConsoleSink::ConsoleSink(int out_fd, int err_fd):
+    file_(DEFAULT_CONSOLE_BUFFER_SIZE, out_fd),
+    err_file_(DEFAULT_CONSOLE_BUFFER_SIZE, err_fd),
+    colors_(-1),
+    is_block_buffered_(!LOGGER_ISATTY(out_fd)),
+    stderr_level_(-1),
+    is_tty_(LOGGER_ISATTY(out_fd)),
+    is_err_tty_(LOGGER_ISATTY(err_fd)),
+    is_idle_flush_started_(false){
+}
+
+void ConsoleSink::write(const structLogMsg &msg_log, const std::string &line){
+    std::lock_guard<std::mutex> lock(mutex_);
+    int level = (int) msg_log.log_level;
+    if (level <= stderr_level_.load(std::memory_order_relaxed)){
+        // Pending lines are written first, so the order is kept when both streams go to the same place
+        flush_();
+        append_line_(err_file_, is_err_tty_, msg_log, line);
+        err_file_.flush();
+        return;
+    }
+
+    append_line_(file_, is_tty_, msg_log, line);
+    if (!is_block_buffered_.load(std::memory_order_relaxed)){
+        if (add_to_batch_(batch_)) flush_();
+        return;
+    }
+
+    // Only the first pending line reads the clock. Later lines are copied to the buffer, which is written once it is full.
+    if (batch_.records++ == 0) batch_.start = std::chrono::steady_clock::now();
+    if (level <= (int) enumLogLevel::ERROR_){
+        flush_();
+    }
+    else if (!is_idle_flush_started_){
+        // Housekeeping thread writes pending lines of an idle console
+        is_idle_flush_started_ = true;
+        Logger::start_console_flush_();
+    }
+}
+
+void ConsoleSink::flush(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_();
+    err_file_.flush();
+}
+
+void ConsoleSink::flush_on_crash() noexcept{
+    // Mutex is not taken, since the crashed thread may hold it
+    file_.flush_on_crash();
+    err_file_.flush_on_crash();
+}
+
+void ConsoleSink::commit(bool force){
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_block_buffered_.load(std::memory_order_relaxed)){
+        if (is_batch_due_(batch_, force)) flush_();
+        return;
+    }
+    if (batch_.records > 0 && (force || std::chrono::steady_clock::now() - batch_.start >= std::chrono::milliseconds(DEFAULT_CONSOLE_FLUSH_INTERVAL_MS))){
+        flush_();
+    }
+}
+
+void ConsoleSink::set_colors(bool is_enabled) noexcept{
+    colors_.store(is_enabled? 1: 0, std::memory_order_relaxed);
+}
+
+void ConsoleSink::set_block_buffered(bool is_enabled) noexcept{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_();
+    }
+    is_block_buffered_.store(is_enabled, std::memory_order_relaxed);
+}
+
+void ConsoleSink::set_stderr_routing(bool is_enabled, enumLogLevel level) noexcept{
+    stderr_level_.store(is_enabled? (int) level: -1, std::memory_order_relaxed);
+}
+
+bool ConsoleSink::is_block_buffered() const noexcept{
+    return is_block_buffered_.load(std::memory_order_relaxed);
+}
+
+bool ConsoleSink::is_tty() const noexcept{
+    return is_tty_;
+}
+
+/*********************************************************************
+ *
+ * FileSink
+ *
+*********************************************************************/
+
+void FileSink::apply_flush_policy_(enumLogLevel log_level){
+    bool is_flush_required = false;
+    switch (flush_policy_){
+        case enumFlushPolicy::ALWAYS:
+            is_flush_required = add_to_batch_(batch_);
+            break;
+        case enumFlushPolicy::EVERY_N_BYTES:
+            is_flush_required = file_.buffered_size() >= flush_threshold_;
+            break;
+        case enumFlushPolicy::EVERY_N_MS:
+            is_flush_required = std::chrono::steady_clock::now() - last_flush_time_ >= std::chrono::milliseconds(flush_threshold_);
+            break;
+        case enumFlushPolicy::ON_ERROR:
+            is_flush_required = log_level == enumLogLevel::FATAL_ || log_level == enumLogLevel::ERROR_;
+            break;
+    }
+    if (is_flush_required) flush_();
+}
+
+void FileSink::flush_(){
+    if (file_.buffered_size() > 0){
+        auto start = std::chrono::steady_clock::now();
+        if (!file_.flush()) Logger::error_handler_("Log file cannot be flushed.");
+        LogStats::add_flush((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    batch_.records = 0;
+    last_flush_time_ = std::chrono::steady_clock::now();
+}
+
+std::string FileSink::add_timestamp_prefix_(const structTimestamp &ts) const{
+    std::string result;
+    std::string timestamp_prefix = format_time(ts, DEFAULT_TIMESTAMP_PREFIX_FORMAT);
+    if (root_filename_.empty()){
+        result = timestamp_prefix + DEFAULT_LOG_EXTENSION;
+    }
+    else{
+        result = timestamp_prefix + "_" + root_filename_;
+    }
+    return result;
+}
+
+void FileSink::rotate_(const structTimestamp &ts){
+    std::string next_filename = filename_;
+    if (timestamp_prefix_enabled_){
+        next_filename = add_timestamp_prefix_(ts);
+        std::string file_format;
+        if (get_file_format(next_filename, file_format) < 0) next_filename += DEFAULT_LOG_EXTENSION;
+    }
+
+    file_.close();
+    if (next_filename == filename_){
+        // Same filename is used again, so the current file is moved aside
+        std::error_code ec;
+        std::filesystem::rename(file_dir_ + filename_, file_dir_ + make_rotated_filename_(ts), ec);
+        if (ec) Logger::error_handler_("Log file cannot be rotated: " + ec.message());
+    }
+
+    filename_ = next_filename;
+    if (!file_.open(file_dir_ + filename_)) Logger::error_handler_("The log file cannot be opened.");
+    next_rollover_ns_ = compute_next_rollover_(ts.tm_epoch_ns);
+
+    if (rotation_policy_.max_files > 0) request_prune_();
+}
+
+int64_t FileSink::compute_next_rollover_(int64_t now_ns) const{
+    int64_t next_ns = INT64_MAX;
+
+    if (rotation_policy_.interval_sec > 0){
+        int64_t interval_ns = (int64_t) rotation_policy_.interval_sec * 1000000000LL;
+        next_ns = (now_ns / interval_ns + 1) * interval_ns;
+    }
+
+    if (timestamp_prefix_enabled_){
+        std::time_t time = (std::time_t) (now_ns / 1000000000LL);
+        struct tm time_info;
+        #ifdef PLATFORM_WINDOWS
+            localtime_s(&time_info, &time);
+        #else
+            localtime_r(&time, &time_info);
+        #endif
+        // mktime normalizes the day after the end of the month
+        time_info.tm_mday += 1;
+        time_info.tm_hour = 0;
+        time_info.tm_min = 0;
+        time_info.tm_sec = 0;
+        time_info.tm_isdst = -1;
+        std::time_t midnight = std::mktime(&time_info);
+        if (midnight != (std::time_t) -1) next_ns = std::min<int64_t>(next_ns, (int64_t) midnight * 1000000000LL);
+    }
+    return next_ns;
+}
+
+std::string FileSink::make_rotated_filename_(const structTimestamp &ts) const{
+    std::string file_format;
+    int pos = get_file_format(filename_, file_format);
+    std::string stem = (pos < 0)? filename_: filename_.substr(0, (std::size_t) pos);
+    if (pos < 0) file_format.clear();
+
+    std::string rotated_stem = stem + "." + format_time(ts, DEFAULT_ROTATION_SUFFIX_FORMAT);
+    std::string rotated_filename = rotated_stem + file_format;
+    // Files rotated within the same millisecond get a sequence number
+    std::error_code ec;
+    for (int seq=1; std::filesystem::exists(file_dir_ + rotated_filename, ec); seq++){
+        rotated_filename = rotated_stem + "." + std::to_string(seq) + file_format;
+    }
+    return rotated_filename;
+}
+
+void FileSink::request_prune_() const{
+    Logger::request_prune_({file_dir_, root_filename_, filename_, rotation_policy_.max_files});
+}
+
+bool FileSink::is_rotated_filename_(const std::string &filename, const std::string &root_filename){
+    std::string base_filename = root_filename;
+    std::string file_format;
+    if (get_file_format(base_filename, file_format) < 0){
+        base_filename += DEFAULT_LOG_EXTENSION;
+        file_format = DEFAULT_LOG_EXTENSION;
+    }
+    std::string stem = base_filename.substr(0, base_filename.size() - file_format.size());
+
+    auto is_digit = [](char c){ return c >= '0' && c <= '9'; };
+
+    // Files of previous days have "YYYYmmdd_" prefix
+    std::string_view name(filename);
+    if (name.size() > 9 && name[8] == '_' && std::all_of(name.begin(), name.begin() + 8, is_digit)){
+        name.remove_prefix(9);
+        if (name == base_filename) return true;
+    }
+
+    // Renamed files are "<stem>.<digits, '-' and '.'><extension>"
+    if (name.size() <= stem.size() + 1 + file_format.size()) return false;
+    if (name.compare(0, stem.size(), stem) != 0 || name[stem.size()] != '.') return false;
+    if (name.compare(name.size() - file_format.size(), file_format.size(), file_format) != 0) return false;
+    std::string_view suffix = name.substr(stem.size() + 1, name.size() - stem.size() - 1 - file_format.size());
+    return std::all_of(suffix.begin(), suffix.end(), [&](char c){ return is_digit(c) || c == '-' || c == '.'; });
+}
+
+FileSink::FileSink(std::size_t buffer_size):
+    file_(buffer_size),
+    timestamp_prefix_enabled_(false),
+    flush_policy_(DEFAULT_FLUSH_POLICY),
+    flush_threshold_(DEFAULT_FLUSH_THRESHOLD),
+    last_flush_time_(std::chrono::steady_clock::now()),
+    rotation_max_file_size_(UINT64_MAX),
+    next_rollover_ns_(INT64_MAX){
+}
+
+bool FileSink::open(const std::string &filename, const std::string &file_dir, bool timestamp_prefix_enabled){
+    std::string temp_out_filename = "";
+    std::string file_format;
+    structTimestamp ts;
+    get_current_timestamp_struct(ts);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    root_filename_ = filename;
+    timestamp_prefix_enabled_ = timestamp_prefix_enabled;
+    temp_out_filename = timestamp_prefix_enabled? add_timestamp_prefix_(ts): root_filename_;
+
+    // Check empty filename
+    if (temp_out_filename.empty()){
+        Logger::error_handler_("Filename is empty.");
+        return false;
+    }
+
+    // Check file extension if nothing is provided set to default format (.log).
+    auto r = get_file_format(temp_out_filename, file_format);
+    if (r<0){
+        temp_out_filename += DEFAULT_LOG_EXTENSION;
+    }
+    // Check filename only contains with file extension
+    else if (r==0){
+        Logger::error_handler_("Filename is not valid: " + temp_out_filename);
+        return false;
+    }
+    else{}
+
+    std::string temp_out_file_dir = normalize_dir(file_dir);
+
+    // Log file is kept open until the sink is destroyed or the file is rotated
+    if (!file_.open(temp_out_file_dir + temp_out_filename, true)){
+        Logger::error_handler_("The log file cannot be opened.");
+        return false;
+    }
+    last_flush_time_ = std::chrono::steady_clock::now();
+
+    filename_ = temp_out_filename;
+    file_dir_ = temp_out_file_dir;
+    next_rollover_ns_ = compute_next_rollover_(ts.tm_epoch_ns);
+    if (rotation_policy_.max_files > 0) request_prune_();
+    return true;
+}
+
+void FileSink::write(const structLogMsg &msg_log, const std::string &line){
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+
+    // Rollover boundary is precomputed, so the time check is a single compare per message
+    if (msg_log.timestamp.tm_epoch_ns >= next_rollover_ns_ || file_.file_size() >= rotation_max_file_size_){
+        rotate_(msg_log.timestamp);
+    }
+
+    if (!file_.write(line.data(), line.size())){
+        Logger::error_handler_("Log file cannot be written.");
+        return;
+    }
+    add_bytes_written_(line.size());
+    apply_flush_policy_(msg_log.log_level);
+}
+
+void FileSink::flush(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_();
+}
+
+void FileSink::close(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_();
+    file_.close();
+}
+
+void FileSink::flush_on_crash() noexcept{
+    // Mutex is not taken, since the crashed thread may hold it
+    file_.flush_on_crash();
+}
+
+void FileSink::commit(bool force){
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool is_flush_due = is_batch_due_(batch_, force);
+    if (flush_policy_ == enumFlushPolicy::EVERY_N_MS && file_.buffered_size() > 0){
+        is_flush_due |= std::chrono::steady_clock::now() - last_flush_time_ >= std::chrono::milliseconds(flush_threshold_);
+    }
+    if (is_flush_due) flush_();
+}
+
+std::string FileSink::get_path(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.is_open()? file_dir_ + filename_: "";
+}
+
+void FileSink::set_flush_policy(enumFlushPolicy policy, uint64_t threshold){
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_policy_ = policy;
+    flush_threshold_ = threshold;
+    last_flush_time_ = std::chrono::steady_clock::now();
+}
+
+void FileSink::set_buffer_size(std::size_t size){
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.set_buffer_size(size);
+}
+
+bool FileSink::set_segment_size(std::size_t segment_size){
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_.set_segment_size(segment_size);
+}
+
+void FileSink::set_rotation(const structRotationPolicy &policy){
+    std::lock_guard<std::mutex> lock(mutex_);
+    rotation_policy_ = policy;
+    rotation_max_file_size_ = (policy.max_file_size > 0)? policy.max_file_size: UINT64_MAX;
+    next_rollover_ns_ = compute_next_rollover_(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+
+    // Rotated files of previous runs are pruned as well
+    if (file_.is_open() && policy.max_files > 0) request_prune_();
+}
+
+void FileSink::prune_rotated_files(const structPruneRequest &request){
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> rotated_files;
+    std::error_code ec;
+
+    for (std::filesystem::directory_iterator it(request.file_dir, ec), end; !ec && it != end; it.increment(ec)){
+        std::string filename = it->path().filename().string();
+        if (filename == request.active_filename || !is_rotated_filename_(filename, request.root_filename)) continue;
+        if (!it->is_regular_file(ec)) continue;
+        rotated_files.emplace_back(it->last_write_time(ec), it->path());
+    }
+    if (rotated_files.size() <= request.max_files) return;
+
+    // Newest files are kept
+    std::sort(rotated_files.begin(), rotated_files.end(), [](const auto &a, const auto &b){ return a.first > b.first; });
+    for (std::size_t i=request.max_files; i<rotated_files.size(); i++){
+        if (!std::filesystem::remove(rotated_files[i].second, ec)) Logger::error_handler_("Rotated log file cannot be deleted: " + rotated_files[i].second.string());
+    }
+}
+
+/*********************************************************************
+ *
+ * NullSink
+ *
+*********************************************************************/
+
+void NullSink::write(const structLogMsg &msg_log, const std::string &line){
+    (void) msg_log;
+    (void) line;
+}
+
+/*********************************************************************
+ *
+ * MemorySink
+ *
+*********************************************************************/
+
+MemorySink::MemorySink(std::size_t capacity):
+    capacity_(capacity){
+}
+
+void MemorySink::write(const structLogMsg &msg_log, const std::string &line){
+    (void) msg_log;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ > 0 && lines_.size() >= capacity_) lines_.pop_front();
+    lines_.push_back(line);
+}
+
+std::vector<std::string> MemorySink::get_lines() const{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<std::string>(lines_.begin(), lines_.end());
+}
+
+void MemorySink::clear(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_.clear();
+}
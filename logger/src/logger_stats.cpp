@@ -0,0 +1,99 @@
+#include <logger_stats.h>
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+using namespace logger;
+
+namespace{
+
+    std::mutex registry_mutex;
+    std::vector<structThreadCounters*> registry;
+    // Counters of exited threads
+    structThreadCounters retired_counters;
+
+    void add_counters(structThreadCounters &dst, const structThreadCounters &src){
+        for (std::size_t i=0; i<LOG_LEVEL_COUNT; i++) dst.level_counts[i].fetch_add(src.level_counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dst.format_time_ns.fetch_add(src.format_time_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dst.suppressed_count.fetch_add(src.suppressed_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dst.duplicate_count.fetch_add(src.duplicate_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    /**
+     * @struct structCountersHandle
+     *
+     * @brief This struct registers the counters of a thread and moves them into the retired total when the thread exits
+    */
+    struct structCountersHandle{
+        structThreadCounters counters;
+
+        structCountersHandle(){
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            registry.push_back(&counters);
+        }
+
+        ~structCountersHandle();
+    };
+
+    // Trivially destructible, so it can still be read after the handle is destroyed
+    thread_local bool is_counters_released = false;
+
+    structCountersHandle::~structCountersHandle(){
+        is_counters_released = true;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        add_counters(retired_counters, counters);
+        registry.erase(std::remove(registry.begin(), registry.end(), &counters), registry.end());
+    }
+
+    // Counters of threads that log while they are being destroyed. Shared, so they may lose increments.
+    structThreadCounters exiting_counters;
+}
+
+std::atomic<uint64_t> LogStats::flush_count_{0};
+std::atomic<uint64_t> LogStats::flush_latency_histogram_[LOGGER_FLUSH_HISTOGRAM_BUCKETS]{};
+std::atomic<uint64_t> LogStats::queue_high_water_{0};
+
+/*********************************************************************
+ *
+ * Public Functions
+ *
+*********************************************************************/
+
+structThreadCounters &LogStats::local() noexcept{
+    if (is_counters_released) return exiting_counters;
+    thread_local structCountersHandle handle;
+    return handle.counters;
+}
+
+void LogStats::add_flush(uint64_t ns) noexcept{
+    flush_count_.fetch_add(1, std::memory_order_relaxed);
+
+    std::size_t bucket = 0;
+    for (uint64_t us = ns / 1000; us >= 2 && bucket < LOGGER_FLUSH_HISTOGRAM_BUCKETS - 1; us >>= 1) bucket++;
+    flush_latency_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogStats::update_queue_depth(uint64_t depth) noexcept{
+    uint64_t high_water = queue_high_water_.load(std::memory_order_relaxed);
+    while (depth > high_water && !queue_high_water_.compare_exchange_weak(high_water, depth, std::memory_order_relaxed)){}
+}
+
+void LogStats::collect(structLoggerStats &stats){
+    structThreadCounters total;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        add_counters(total, retired_counters);
+        for (const structThreadCounters *counters: registry) add_counters(total, *counters);
+    }
+    add_counters(total, exiting_counters);
+
+    for (std::size_t i=0; i<LOG_LEVEL_COUNT; i++) stats.level_counts[i] = total.level_counts[i].load(std::memory_order_relaxed);
+    stats.format_time_ns = total.format_time_ns.load(std::memory_order_relaxed);
+    stats.suppressed_count = total.suppressed_count.load(std::memory_order_relaxed);
+    stats.duplicate_count = total.duplicate_count.load(std::memory_order_relaxed);
+
+    stats.flush_count = flush_count_.load(std::memory_order_relaxed);
+    for (std::size_t i=0; i<LOGGER_FLUSH_HISTOGRAM_BUCKETS; i++) stats.flush_latency_histogram[i] = flush_latency_histogram_[i].load(std::memory_order_relaxed);
+    stats.queue_high_water = queue_high_water_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,220 @@
+#include <logger_timestamp.h>
+
+#include <atomic>
+#include <charconv>
+
+using namespace logger;
+
+#define TIMESTAMP_CACHE_SLOTS   4
+#define TIMESTAMP_MAX_MSEC      4
+
+namespace{
+
+    /**
+     * @struct structTimestampCache
+     *
+     * @brief This struct keeps rendered timestamp of the last second of a formatter on a thread
+    */
+    struct structTimestampCache{
+        uint64_t formatter_id = 0;                  ///< Id of the formatter that owns the slot
+        int64_t epoch_sec = 0;                      ///< Second of the rendered text
+        std::string rendered;                       ///< Rendered text
+        uint32_t msec_offsets[TIMESTAMP_MAX_MSEC];  ///< Offsets of millisecond digits
+        uint32_t msec_count = 0;                    ///< Number of millisecond fields
+    };
+
+    thread_local structTimestampCache timestamp_cache[TIMESTAMP_CACHE_SLOTS];
+
+    uint64_t next_formatter_id(){
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    int64_t floor_div(int64_t a, int64_t b){
+        return (a >= 0)? a / b: -((-a + b - 1) / b);
+    }
+
+    void append_digits(std::string &out, long long value, int width){
+        char num[24];
+        auto r = std::to_chars(num, num + sizeof(num), value);
+        for (int i = (int) (r.ptr - num); i < width; i++) out.push_back('0');
+        out.append(num, r.ptr);
+    }
+
+    void write_msec(char *dst, long msec){
+        dst[0] = (char) ('0' + (msec / 100) % 10);
+        dst[1] = (char) ('0' + (msec / 10) % 10);
+        dst[2] = (char) ('0' + msec % 10);
+    }
+
+    // Converts days since epoch to civil date in proleptic Gregorian calendar
+    void civil_from_days(int64_t z, int64_t &year, int &month, int &day){
+        z += 719468;
+        const int64_t era = (z >= 0? z: z - 146096) / 146097;
+        const int64_t doe = z - era * 146097;
+        const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int64_t mp = (5 * doy + 2) / 153;
+        day = (int) (doy - (153 * mp + 2) / 5 + 1);
+        month = (int) (mp < 10? mp + 3: mp - 9);
+        year = yoe + era * 400 + (month <= 2);
+    }
+
+    long msec_of(const structTimestamp &ts, enumTimestampMode mode){
+        if (mode == enumTimestampMode::ISO8601_UTC) return (long) (floor_div(ts.tm_epoch_ns, 1000000) - floor_div(ts.tm_epoch_ns, 1000000000) * 1000);
+        return ts.tm_msec;
+    }
+}
+
+/*********************************************************************
+ *
+ * Private Functions
+ *
+*********************************************************************/
+
+void TimestampFormatter::render_(const structTimestamp &ts, std::string &out, uint32_t *msec_offsets, uint32_t *msec_count) const{
+    std::size_t start = out.size();
+    uint32_t count = 0;
+    auto mark_msec = [&](){
+        if (msec_offsets != nullptr && count < TIMESTAMP_MAX_MSEC) msec_offsets[count++] = (uint32_t) (out.size() - start);
+    };
+
+    switch (mode_){
+        case enumTimestampMode::EPOCH_NS:
+            append_digits(out, ts.tm_epoch_ns, 0);
+            break;
+
+        case enumTimestampMode::ISO8601_UTC: {
+            int64_t epoch_sec = floor_div(ts.tm_epoch_ns, 1000000000);
+            int64_t days = floor_div(epoch_sec, 86400);
+            int64_t sec_of_day = epoch_sec - days * 86400;
+            int64_t year;
+            int month, day;
+            civil_from_days(days, year, month, day);
+
+            append_digits(out, year, 4); out.push_back('-');
+            append_digits(out, month, 2); out.push_back('-');
+            append_digits(out, day, 2); out.push_back('T');
+            append_digits(out, sec_of_day / 3600, 2); out.push_back(':');
+            append_digits(out, (sec_of_day / 60) % 60, 2); out.push_back(':');
+            append_digits(out, sec_of_day % 60, 2); out.push_back('.');
+            mark_msec();
+            append_digits(out, msec_of(ts, mode_), 3);
+            out.push_back('Z');
+            break;
+        }
+
+        case enumTimestampMode::PATTERN:
+            for (const auto &token: tokens_){
+                switch (token.type){
+                    case enumTimestampToken::LITERAL: out.append(literals_, token.offset, token.size); break;
+                    case enumTimestampToken::YEAR: append_digits(out, 1900 + ts.tm_year, 4); break;
+                    case enumTimestampToken::MONTH: append_digits(out, ts.tm_mon + 1, 2); break;
+                    case enumTimestampToken::DAY: append_digits(out, ts.tm_mday, 2); break;
+                    case enumTimestampToken::HOUR: append_digits(out, ts.tm_hour, 2); break;
+                    case enumTimestampToken::MINUTE: append_digits(out, ts.tm_min, 2); break;
+                    case enumTimestampToken::SECOND: append_digits(out, ts.tm_sec, 2); break;
+                    case enumTimestampToken::MILLISECOND: mark_msec(); append_digits(out, ts.tm_msec, 3); break;
+                }
+            }
+            break;
+    }
+
+    if (msec_count != nullptr) *msec_count = count;
+}
+
+/*********************************************************************
+ *
+ * Public Functions
+ *
+*********************************************************************/
+
+TimestampFormatter::TimestampFormatter(): TimestampFormatter(DEFAULT_TIMESTAMP_FORMAT){
+}
+
+TimestampFormatter::TimestampFormatter(const std::string &format){
+    compile(format);
+}
+
+void TimestampFormatter::compile(const std::string &format){
+    tokens_.clear();
+    literals_.clear();
+    id_ = next_formatter_id();
+
+    if (format == ISO8601_UTC_TIMESTAMP_FORMAT){
+        mode_ = enumTimestampMode::ISO8601_UTC;
+        return;
+    }
+    if (format == EPOCH_NS_TIMESTAMP_FORMAT){
+        mode_ = enumTimestampMode::EPOCH_NS;
+        return;
+    }
+    mode_ = enumTimestampMode::PATTERN;
+
+    auto add_literal = [this](const char *data, std::size_t size){
+        if (size == 0) return;
+        // Merge consecutive literals into a single token
+        if (!tokens_.empty() && tokens_.back().type == enumTimestampToken::LITERAL){
+            tokens_.back().size += (uint32_t) size;
+        }
+        else{
+            tokens_.push_back({enumTimestampToken::LITERAL, (uint32_t) literals_.size(), (uint32_t) size});
+        }
+        literals_.append(data, size);
+    };
+
+    std::size_t pos = 0;
+    while (pos < format.length()){
+        std::size_t placeholder_pos = format.find('%', pos);
+        if (placeholder_pos == std::string::npos || placeholder_pos + 1 >= format.length()){
+            add_literal(format.data() + pos, format.length() - pos);
+            break;
+        }
+        add_literal(format.data() + pos, placeholder_pos - pos);
+
+        switch (format[placeholder_pos + 1]){
+            case 'Y': tokens_.push_back({enumTimestampToken::YEAR, 0, 0}); break;
+            case 'm': tokens_.push_back({enumTimestampToken::MONTH, 0, 0}); break;
+            case 'd': tokens_.push_back({enumTimestampToken::DAY, 0, 0}); break;
+            case 'H': tokens_.push_back({enumTimestampToken::HOUR, 0, 0}); break;
+            case 'M': tokens_.push_back({enumTimestampToken::MINUTE, 0, 0}); break;
+            case 'S': tokens_.push_back({enumTimestampToken::SECOND, 0, 0}); break;
+            case 'f': tokens_.push_back({enumTimestampToken::MILLISECOND, 0, 0}); break;
+            default:
+                // Unsupported placeholders are written as they are
+                add_literal(format.data() + placeholder_pos, 2);
+        }
+        pos = placeholder_pos + 2;
+    }
+}
+
+void TimestampFormatter::format(const structTimestamp &ts, std::string &out) const{
+    // Timestamps that are not derived from epoch cannot be matched with the cached second
+    if (mode_ == enumTimestampMode::EPOCH_NS || ts.tm_epoch_ns == 0){
+        render_(ts, out, nullptr, nullptr);
+        return;
+    }
+
+    int64_t epoch_sec = floor_div(ts.tm_epoch_ns, 1000000000);
+    structTimestampCache &cache = timestamp_cache[id_ % TIMESTAMP_CACHE_SLOTS];
+    if (cache.formatter_id != id_ || cache.epoch_sec != epoch_sec){
+        cache.rendered.clear();
+        render_(ts, cache.rendered, cache.msec_offsets, &cache.msec_count);
+        cache.formatter_id = id_;
+        cache.epoch_sec = epoch_sec;
+        out += cache.rendered;
+        return;
+    }
+
+    // Same second, only millisecond digits are rewritten
+    std::size_t start = out.size();
+    out += cache.rendered;
+    long msec = msec_of(ts, mode_);
+    for (uint32_t i=0; i<cache.msec_count; i++) write_msec(&out[start + cache.msec_offsets[i]], msec);
+}
+
+std::string TimestampFormatter::format_uncached(const structTimestamp &ts) const{
+    std::string out;
+    render_(ts, out, nullptr, nullptr);
+    return out;
+}
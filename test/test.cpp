@@ -1,46 +1,1025 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
 #include <string>
+#include <vector>
 #include <thread>
+#include <fstream>
+#include <sstream>
+#include <string_view>
 #include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+    #include <csignal>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
 
 #include <logger.h>
+#include <logger_json.h>
+#include <logger_decode.h>
 
 using namespace logger;
 
-int main(){
-    
+// Heap allocations of a thread are counted while counting is enabled on it
+static thread_local bool is_allocation_counted = false;
+static thread_local uint64_t allocation_count = 0;
+
+void *operator new(std::size_t size){
+    if (is_allocation_counted) allocation_count++;
+    void *ptr = std::malloc(size > 0? size: 1);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept{
+    std::free(ptr);
+}
+
+// Output file can be set only once per process, so all test cases share the same log file
+static std::string open_test_log(){
+    if (Logger::get_log_path().empty()) Logger::set_output("log_test.txt");
+    Logger::flush();
+    return Logger::get_log_path();
+}
+
+// Returns lines appended to the log file since the given offset
+static std::vector<std::string> read_log_lines(const std::string &path, std::streamoff offset){
+    Logger::flush();
+    std::ifstream file(path);
+    file.seekg(offset);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) lines.push_back(line);
+    return lines;
+}
+
+static std::streamoff get_file_size(const std::string &path){
+    std::ifstream file(path, std::ios::ate);
+    return file.tellg();
+}
+
+// Splits a log line into its fields (timestamp, level, [source], message)
+static std::vector<std::string> split_fields(const std::string &line){
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, '\t')) fields.push_back(field);
+    return fields;
+}
+
+TEST_CASE("Messages of all levels are logged", "[logger]"){
+    // Enables log color for console depending on its level
     Logger::enable_colors();
-    LogDebug << "This is debug message";
-    LogInfo << "This is info message";
-    LogWarning << "This is warning message";
-    LogError << "This is error message";
-    LogFatal << "This is fatal message";
+    // Creates log file
+    open_test_log();
+
+    LogFatal << "This is fatal message.";
+    LogError << "This is error message.";
+    LogAlert << "This is alert message.";
+    LogWarning << "This is warning message.";
+    LogInfo << "This is info message.";
+    LogDebug << "This is debug message.";
+    LogTrace << "This is trace message.";
+
+    Logger::disable_colors();
+}
+
+TEST_CASE("Log calls below the runtime threshold do not evaluate their operands", "[logger][threshold]"){
+    auto sink = std::make_shared<MemorySink>();
+    structLogFormat fmt;
+    fmt.fmt_timestamp = "";
+    fmt.fmt_delimiter_type = enumDelimiterType::COMMA;
+    fmt.fmt_padding_size = enumPaddingSize::ZERO;
+    sink->set_format(fmt);
+    Logger::add_sink(sink);
+    Logger::set_log_threshold(enumLogLevel::WARNING_);
+
+    int calls = 0;
+    auto f = [&calls](){ return ++calls; };
+    LogDebug << "Discarded " << f();
+    LogInfoF("Discarded {}", f());
+    LogWarning << "Logged " << f();
+    Logger::set_log_threshold(enumLogLevel::TRACE_);
+    Logger::remove_sink(sink);
+
+    CHECK(calls == 1);
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0] == "WARNING,Logged 1\n");
+}
+
+TEST_CASE("Concurrent log calls keep their own level and source", "[logger][thread]"){
+    const int thread_count = 8;
+    const int message_count = 200;
+
+    std::string path = open_test_log();
+    std::streamoff offset = get_file_size(path);
     Logger::enable_source();
-    LogDebug << "This is debug message";
-    LogTrace << "This is trace message";
-    LogWarning << "This is warning message";
+
+    std::vector<int> source_lines(thread_count, 0);
+    std::vector<std::thread> threads;
+    for (int t=0; t<thread_count; t++){
+        threads.emplace_back([t, &source_lines](){
+            for (int i=0; i<message_count; i++){
+                std::string msg = "thread=" + std::to_string(t) + " seq=" + std::to_string(i);
+                switch (t % 4){
+                    case 0: source_lines[t] = __LINE__; LogWarning << msg; break;
+                    case 1: source_lines[t] = __LINE__; LogInfo << msg; break;
+                    case 2: source_lines[t] = __LINE__; LogDebug << msg; break;
+                    case 3: source_lines[t] = __LINE__; LogTrace << msg; break;
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) thread.join();
     Logger::disable_source();
-    LogDebug << "This is debug message";
-    LogInfo << "This is info message";
-    LogWarning << "This is warning message";
-    LogError << "This is error message";
-    LogFatal << "This is fatal message";
-
-    Logger::set_output("log_test.txt", HomeDir + "/log-rec");
-    LogDebug << "This is debug message";
-    LogInfo << "This is info message";
+
+    const char *expected_levels[] = {"WARNING", "INFO", "DEBUG", "TRACE"};
+    std::vector<int> received(thread_count, 0);
+    for (const auto &line: read_log_lines(path, offset)){
+        auto fields = split_fields(line);
+        REQUIRE(fields.size() >= 3);
+        const std::string &msg = fields.back();
+        if (msg.rfind("thread=", 0) != 0) continue;
+
+        int t = std::stoi(msg.substr(7));
+        REQUIRE(t >= 0);
+        REQUIRE(t < thread_count);
+        CHECK(fields[1] == expected_levels[t % 4]);
+        // Source field is only shown for DEBUG and TRACE
+        if (t % 4 >= 2){
+            REQUIRE(fields.size() == 4);
+            CHECK(fields[2] == std::string(source_basename(__FILE__)) + ":" + std::to_string(source_lines[t]));
+        }
+        else{
+            CHECK(fields.size() == 3);
+        }
+        received[t]++;
+    }
+    for (int t=0; t<thread_count; t++) CHECK(received[t] == message_count);
+}
+
+TEST_CASE("Binary call sites are formatted as text when binary output is not set", "[logger][binary]"){
+    std::string path = open_test_log();
+    std::streamoff offset = get_file_size(path);
+
+    LogInfoBin("id={} ratio={} name={} ok={} {{literal}}", 42, 0.5, "abc", true);
+
+    auto lines = read_log_lines(path, offset);
+    REQUIRE(lines.size() == 1);
+    auto fields = split_fields(lines[0]);
+    REQUIRE(fields.size() == 3);
+    CHECK(fields[1] == "INFO");
+    CHECK(fields[2] == "id=42 ratio=0.5 name=abc ok=true {literal}");
+}
+
+// Same call sites are logged as text and as binary records
+static void log_binary_calls(){
+    long long min_value = -9223372036854775807LL - 1;
+    LogInfoBin("id={} name={} ok={}", 42, "abc", true);
+    LogWarningBin("offset={} min={} ratio={}", -7, min_value, -0.25);
+    LogErrorBin("path={} grade={}", std::string("/tmp/a b\tc"), 'B');
+}
+
+// Returns the fields of the lines after the timestamp, since records of the two runs are taken at different times
+static std::vector<std::string> strip_timestamps(const std::string &text){
+    std::vector<std::string> lines;
+    std::stringstream ss(text);
+    std::string line;
+    while (std::getline(ss, line)){
+        std::size_t pos = line.find('\t');
+        lines.push_back(pos == std::string::npos? line: line.substr(pos + 1));
+    }
+    return lines;
+}
+
+TEST_CASE("Binary log files are decoded to the text lines of the same calls", "[logger][binary]"){
+    auto sink = std::make_shared<MemorySink>();
+    Logger::add_sink(sink);
+    log_binary_calls();
+    Logger::remove_sink(sink);
+    std::string text;
+    for (const auto &line: sink->get_lines()) text += line;
+    auto expected = strip_timestamps(text);
+    REQUIRE(expected.size() == 3);
+
+    Logger::set_binary_output("log_binary_test.bin", ".");
+    log_binary_calls();
+    Logger::flush();
+    std::ifstream file("log_binary_test.bin", std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::size_t pos = 0;
+    REQUIRE(decode_binary_header(data, pos));
+    std::string decoded;
+    CHECK(decode_binary_entries(data, pos, decoded));
+    CHECK(pos == data.size());
+    CHECK(strip_timestamps(decoded) == expected);
+
+    // Lines before the truncated record are kept
+    std::string truncated = data.substr(0, data.size() - 3);
+    pos = 0;
+    REQUIRE(decode_binary_header(truncated, pos));
+    decoded.clear();
+    CHECK_FALSE(decode_binary_entries(truncated, pos, decoded));
+    CHECK(pos < truncated.size());
+    auto truncated_lines = strip_timestamps(decoded);
+    REQUIRE(truncated_lines.size() == 2);
+    CHECK(truncated_lines[0] == expected[0]);
+    CHECK(truncated_lines[1] == expected[1]);
+
+    std::remove("log_binary_test.bin");
+}
+
+TEST_CASE("Chained values are emitted as a single record", "[logger][record]"){
+    std::string path = open_test_log();
+    std::streamoff offset = get_file_size(path);
+
+    int id = -7;
+    uint64_t count = 18446744073709551615ull;
+    double ms = 1.25;
+    std::string_view view = "view";
+    LogInfo << "id=" << id << " count=" << count << " took " << ms << "ms " << view << ' ' << false << " " << std::string("moved");
+    *(Logger::getInstance()->set_log_level(enumLogLevel::WARNING_)) << std::string(300, 'x') << 1;
+
+    auto lines = read_log_lines(path, offset);
+    REQUIRE(lines.size() == 2);
+    auto fields = split_fields(lines[0]);
+    REQUIRE(fields.size() == 3);
+    CHECK(fields[2] == "id=-7 count=18446744073709551615 took 1.25ms view false moved");
+
+    // Message longer than the inline buffer of the record
+    fields = split_fields(lines[1]);
+    REQUIRE(fields.size() == 3);
+    CHECK(fields[1] == "WARNING");
+    CHECK(fields[2] == std::string(300, 'x') + "1");
+}
+
+TEST_CASE("Format strings are checked and formatted into the record", "[logger][format]"){
+    static_assert(count_placeholders("x={} y={}") == 2, "Two placeholders expected.");
+    static_assert(count_placeholders("{{}} {}") == 1, "Escaped braces are not placeholders.");
+    static_assert(count_placeholders("x={") == -1, "Unmatched brace is an error.");
+
+    std::string path = open_test_log();
+    std::streamoff offset = get_file_size(path);
+
+    LogInfoF("x={} y={} name={} {{escaped}}", 3, -0.75, std::string("abc"));
+    LogWarningF("no arguments");
+
+    auto lines = read_log_lines(path, offset);
+    REQUIRE(lines.size() == 2);
+    CHECK(split_fields(lines[0]).back() == "x=3 y=-0.75 name=abc {escaped}");
+    CHECK(split_fields(lines[1]).back() == "no arguments");
+}
+
+TEST_CASE("Timestamp formats are compiled and cached per second", "[logger][timestamp]"){
+    structTimestamp ts;
+    ts.tm_year = 123;
+    ts.tm_mon = 10;
+    ts.tm_mday = 14;
+    ts.tm_hour = 22;
+    ts.tm_min = 13;
+    ts.tm_sec = 20;
+    ts.tm_msec = 123;
+    ts.tm_epoch_ns = 1700000000123456789LL;
+
+    // Month is zero based in the struct
+    CHECK(format_time(ts, "%Y-%m-%d %H:%M:%S.%f") == "2023-11-14 22:13:20.123");
+    CHECK(format_time(ts, ISO8601_UTC_TIMESTAMP_FORMAT) == "2023-11-14T22:13:20.123Z");
+    CHECK(format_time(ts, EPOCH_NS_TIMESTAMP_FORMAT) == "1700000000123456789");
+
+    TimestampFormatter formatter("[%H:%M:%S.%f]");
+    std::string out;
+    formatter.format(ts, out);
+    CHECK(out == "[22:13:20.123]");
+
+    // Same second, only milliseconds change
+    ts.tm_msec = 987;
+    ts.tm_epoch_ns = 1700000000987000000LL;
+    out.clear();
+    formatter.format(ts, out);
+    CHECK(out == "[22:13:20.987]");
+}
+
+// Returns rotated files of the shared test log ("log_test.<timestamp>.txt")
+static std::vector<std::filesystem::path> list_rotated_test_logs(const std::string &path){
+    std::filesystem::path log_path(path);
+    std::vector<std::filesystem::path> rotated_files;
+    for (const auto &entry: std::filesystem::directory_iterator(log_path.parent_path())){
+        std::string filename = entry.path().filename().string();
+        if (filename != "log_test.txt" && filename.rfind("log_test.", 0) == 0 && entry.path().extension() == ".txt") rotated_files.push_back(entry.path());
+    }
+    return rotated_files;
+}
+
+TEST_CASE("Log file is rotated by size and old files are pruned", "[logger][rotation]"){
+    std::string path = open_test_log();
+    for (const auto &rotated_file: list_rotated_test_logs(path)) std::filesystem::remove(rotated_file);
+
+    structRotationPolicy policy;
+    policy.max_file_size = 1024;
+    policy.max_files = 2;
+    Logger::set_rotation(policy);
+
+    Logger::set_log_level(enumLogLevel::INFO_);
+    for (int i=0; i<100; i++) LogInfoF("Rotation message {} with some padding to fill the file", i);
+    Logger::flush();
+
+    // Active file does not grow much beyond the limit
+    CHECK(get_file_size(path) <= 1024 + 128);
+
+    // Old files are deleted in the background
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (list_rotated_test_logs(path).size() > 2 && std::chrono::steady_clock::now() < deadline){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(list_rotated_test_logs(path).size() == 2);
+
+    Logger::set_rotation(structRotationPolicy());
+    for (const auto &rotated_file: list_rotated_test_logs(path)) std::filesystem::remove(rotated_file);
+}
+
+TEST_CASE("Log file is written through memory-mapped segments", "[logger][mmap]"){
+    std::string path = open_test_log();
+    std::streamoff offset = get_file_size(path);
+
+    Logger::set_file_segment_size(64 * 1024);
+    Logger::set_log_level(enumLogLevel::INFO_);
+    for (int i=0; i<1000; i++) LogInfoF("Mapped message {}", i);
+
+    // Mapped segments are preallocated
+    CHECK(get_file_size(path) % (64 * 1024) == 0);
+
+    // File is truncated to its content when mapping is disabled
+    Logger::set_file_segment_size(0);
+    auto lines = read_log_lines(path, offset);
+    REQUIRE(lines.size() == 1000);
+    CHECK(split_fields(lines.front()).back() == "Mapped message 0");
+    CHECK(split_fields(lines.back()).back() == "Mapped message 999");
+}
+
+TEST_CASE("Records are written in batches without changing the output", "[logger][batch]"){
+    std::string path = open_test_log();
+    std::streamoff offset = get_file_size(path);
+
+    Logger::set_batch_policy(64, 10000000);
+    Logger::set_log_level(enumLogLevel::INFO_);
+    for (int i=0; i<200; i++) LogInfoF("Batched message {}", i);
+
+    // Only complete batches are written before flush
+    std::ifstream file(path);
+    file.seekg(offset);
+    std::size_t written = 0;
+    std::string line;
+    while (std::getline(file, line)) written++;
+    CHECK(written == 192);
+
+    auto lines = read_log_lines(path, offset);
+    Logger::set_batch_policy(1);
+    REQUIRE(lines.size() == 200);
+    for (int i=0; i<200; i++) CHECK(split_fields(lines[i]).back() == "Batched message " + std::to_string(i));
+}
+
+TEST_CASE("Log file is flushed according to its flush policy", "[logger][flush]"){
+    std::string path = open_test_log();
+    Logger::set_log_level(enumLogLevel::INFO_);
+
+    // Default policy writes every message immediately
+    std::streamoff offset = get_file_size(path);
+    LogInfo << "Always flushed";
+    CHECK(get_file_size(path) > offset);
+
+    // Messages are kept in the buffer until it holds the threshold
+    Logger::set_flush_policy(enumFlushPolicy::EVERY_N_BYTES, 2048);
+    offset = get_file_size(path);
+    LogInfo << "Below threshold";
+    CHECK(get_file_size(path) == offset);
+    for (int i=0; i<100 && get_file_size(path) == offset; i++) LogInfoF("Filling buffer {}", i);
+    CHECK(get_file_size(path) - offset >= 2048);
+    Logger::flush();
+
+    // Only ERROR and FATAL messages write the buffer
+    Logger::set_flush_policy(enumFlushPolicy::ON_ERROR);
+    offset = get_file_size(path);
+    LogWarning << "Waits for error";
+    CHECK(get_file_size(path) == offset);
+    LogError << "Error flushes";
+    auto lines = read_log_lines(path, offset);
+    REQUIRE(lines.size() == 2);
+    CHECK(split_fields(lines[0]).back() == "Waits for error");
+    CHECK(split_fields(lines[1]).back() == "Error flushes");
+
+    // Buffer is written by the first message after the interval
+    Logger::set_flush_policy(enumFlushPolicy::EVERY_N_MS, 50);
+    offset = get_file_size(path);
+    LogInfo << "Within interval";
+    CHECK(get_file_size(path) == offset);
     std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    LogInfo << "After interval";
+    CHECK(get_file_size(path) > offset);
+
+    Logger::set_flush_policy(DEFAULT_FLUSH_POLICY);
+    lines = read_log_lines(path, offset);
+    REQUIRE(lines.size() == 2);
+    CHECK(split_fields(lines[1]).back() == "After interval");
+}
+
+TEST_CASE("Sinks filter by their own level and format", "[logger][sink]"){
+    auto error_sink = std::make_shared<MemorySink>();
+    error_sink->set_level(enumLogLevel::ERROR_);
+
+    structLogFormat fmt;
+    fmt.fmt_timestamp = "";
+    fmt.fmt_delimiter_type = enumDelimiterType::COMMA;
+    fmt.fmt_padding_size = enumPaddingSize::ZERO;
+    auto compact_sink = std::make_shared<MemorySink>();
+    compact_sink->set_format(fmt);
+
+    Logger::add_sink(error_sink);
+    Logger::add_sink(compact_sink);
+    LogErrorF("Disk {} failed", 3);
+    LogInfo << "Info message";
+    Logger::remove_sink(error_sink);
+    Logger::remove_sink(compact_sink);
+    LogError << "Not captured";
+
+    auto error_lines = error_sink->get_lines();
+    REQUIRE(error_lines.size() == 1);
+    CHECK(split_fields(error_lines[0]).back() == "Disk 3 failed\n");
+
+    auto compact_lines = compact_sink->get_lines();
+    REQUIRE(compact_lines.size() == 2);
+    CHECK(compact_lines[0] == "ERROR,Disk 3 failed\n");
+    CHECK(compact_lines[1] == "INFO,Info message\n");
+
+    // Removed sinks are closed, and released once no thread reads the list that holds them
+    auto file_sink = std::make_shared<FileSink>();
+    REQUIRE(file_sink->open("log_sink_test", "."));
+    std::string path = file_sink->get_path();
+    Logger::add_sink(file_sink);
+    LogError << "Written before removal";
+    Logger::remove_sink(file_sink);
+    CHECK(file_sink->get_path().empty());
+    auto lines = read_log_lines(path, 0);
+    REQUIRE(lines.size() == 1);
+    CHECK(split_fields(lines[0]).back() == "Written before removal");
 
-    LogWarning << "This is warning message";
-    LogError << "This is error message";
-    LogFatal << "This is fatal message";
-    Logger::set_output("./log_test.txt");
-    //LogWarning << HomeDir;
-    LogInfo << Logger::get_log_path();
-    *(Logger::getInstance()->set_log_level(enumLogLevel::DEBUG_)) << Logger::get_log_path();
-    std::string u = "uuuu";
-    char g[] = "gnfjd";
-    LogError << u;
-    LogError << g;
-    
-    return 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (file_sink.use_count() > 1 && std::chrono::steady_clock::now() < deadline){
+        Logger::flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(file_sink.use_count() == 1);
+    CHECK(error_sink.use_count() == 1);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Category loggers inherit levels from their parents", "[logger][category]"){
+    structLogFormat fmt;
+    fmt.fmt_timestamp = "";
+    fmt.fmt_delimiter_type = enumDelimiterType::COMMA;
+    fmt.fmt_padding_size = enumPaddingSize::ZERO;
+    auto sink = std::make_shared<MemorySink>();
+    sink->set_format(fmt);
+    Logger::add_sink(sink);
+
+    Logger::set_log_threshold(enumLogLevel::INFO_);
+    LogCategory tcp = Logger::get("net.tcp");
+    LogCategory net = Logger::get("net");
+    LogCategory db = Logger::get("db.query");
+    CHECK(tcp.name() == "net.tcp");
+    CHECK(Logger::get("net.tcp").name().data() == tcp.name().data());
+
+    // Only the subtree of net.tcp is turned up
+    Logger::set_category_level("net.tcp", enumLogLevel::TRACE_);
+    CHECK(tcp.is_level_enabled(enumLogLevel::TRACE_));
+    CHECK(Logger::get("net.tcp.rx").get_level() == enumLogLevel::TRACE_);
+    CHECK_FALSE(net.is_level_enabled(enumLogLevel::DEBUG_));
+    CHECK_FALSE(db.is_level_enabled(enumLogLevel::DEBUG_));
+    LogTraceIn(tcp) << "Segment sent";
+    LogTraceIn(db) << "Not captured";
+    LogInfoIn(db) << "Query done";
+
+    // Categories without their own level follow changes of their parents and the runtime threshold
+    Logger::set_category_level("net", enumLogLevel::DEBUG_);
+    Logger::reset_category_level("net.tcp");
+    CHECK(tcp.get_level() == enumLogLevel::DEBUG_);
+    Logger::set_log_threshold(enumLogLevel::WARNING_);
+    CHECK_FALSE(db.is_level_enabled(enumLogLevel::INFO_));
+    CHECK(net.is_level_enabled(enumLogLevel::DEBUG_));
+
+    Logger::reset_category_level("net");
+    Logger::set_log_threshold(enumLogLevel::TRACE_);
+    Logger::remove_sink(sink);
+
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0] == "TRACE,net.tcp,Segment sent\n");
+    CHECK(lines[1] == "INFO,db.query,Query done\n");
+}
+
+TEST_CASE("Lines of custom formats are laid out exactly for every level", "[logger][layout]"){
+    static constexpr structSourceLocation location{"/src/app/main.cpp", 12, "main.cpp:12", 11};
+    structLogMsg msg;
+    msg.timestamp.tm_year = 124;
+    msg.timestamp.tm_mon = 0;
+    msg.timestamp.tm_mday = 2;
+    msg.timestamp.tm_hour = 3;
+    msg.timestamp.tm_min = 4;
+    msg.timestamp.tm_sec = 5;
+    msg.msg = "Ready";
+
+    // Timestamp with dash delimiter and two spaces of padding
+    structLogFormat dash_fmt;
+    dash_fmt.fmt_timestamp = "%Y-%m-%d %H:%M:%S";
+    dash_fmt.fmt_delimiter_type = enumDelimiterType::DASH;
+    dash_fmt.fmt_padding_size = enumPaddingSize::TWO;
+    MemorySink dash_sink;
+    dash_sink.set_format(dash_fmt);
+
+    // No timestamp, so lines start with the level without a separator
+    structLogFormat comma_fmt;
+    comma_fmt.fmt_timestamp = "";
+    comma_fmt.fmt_delimiter_type = enumDelimiterType::COMMA;
+    comma_fmt.fmt_padding_size = enumPaddingSize::ONE;
+    MemorySink comma_sink;
+    comma_sink.set_format(comma_fmt);
+
+    const std::vector<std::pair<enumLogLevel, std::vector<std::string>>> expected{
+        {enumLogLevel::FATAL_,   {"2024-01-02 03:04:05  -FATAL  -Ready\n",   "2024-01-02 03:04:05  -FATAL  -main.cpp:12  -Ready\n",   "FATAL ,Ready\n",   "FATAL ,main.cpp:12 ,Ready\n"}},
+        {enumLogLevel::ERROR_,   {"2024-01-02 03:04:05  -ERROR  -Ready\n",   "2024-01-02 03:04:05  -ERROR  -main.cpp:12  -Ready\n",   "ERROR ,Ready\n",   "ERROR ,main.cpp:12 ,Ready\n"}},
+        {enumLogLevel::ALERT_,   {"2024-01-02 03:04:05  -ALERT  -Ready\n",   "2024-01-02 03:04:05  -ALERT  -main.cpp:12  -Ready\n",   "ALERT ,Ready\n",   "ALERT ,main.cpp:12 ,Ready\n"}},
+        {enumLogLevel::WARNING_, {"2024-01-02 03:04:05  -WARNING  -Ready\n", "2024-01-02 03:04:05  -WARNING  -main.cpp:12  -Ready\n", "WARNING ,Ready\n", "WARNING ,main.cpp:12 ,Ready\n"}},
+        {enumLogLevel::INFO_,    {"2024-01-02 03:04:05  -INFO  -Ready\n",    "2024-01-02 03:04:05  -INFO  -main.cpp:12  -Ready\n",    "INFO ,Ready\n",    "INFO ,main.cpp:12 ,Ready\n"}},
+        {enumLogLevel::DEBUG_,   {"2024-01-02 03:04:05  -DEBUG  -Ready\n",   "2024-01-02 03:04:05  -DEBUG  -main.cpp:12  -Ready\n",   "DEBUG ,Ready\n",   "DEBUG ,main.cpp:12 ,Ready\n"}},
+        {enumLogLevel::TRACE_,   {"2024-01-02 03:04:05  -TRACE  -Ready\n",   "2024-01-02 03:04:05  -TRACE  -main.cpp:12  -Ready\n",   "TRACE ,Ready\n",   "TRACE ,main.cpp:12 ,Ready\n"}},
+    };
+    for (const auto &level: expected){
+        msg.log_level = level.first;
+        std::vector<std::string> lines;
+        for (const LineFormatter *formatter: {dash_sink.get_formatter(), comma_sink.get_formatter()}){
+            for (const structSourceLocation *source: {(const structSourceLocation*) nullptr, &location}){
+                msg.source = source;
+                lines.emplace_back();
+                formatter->format(msg, lines.back());
+            }
+        }
+        CHECK(lines == level.second);
+    }
+}
+
+TEST_CASE("Source locations are rendered at compile time", "[logger][source]"){
+    static constexpr structSourceText<sizeof("/src/app/main.cpp")> text("/src/app/main.cpp", 1207);
+    static_assert(std::string_view(text.data, text.size) == "main.cpp:1207", "Source text is rendered at compile time");
+    CHECK(std::string_view(source_basename("C:\\app\\io.cpp")) == "io.cpp");
+
+    const structSourceLocation *locations[2];
+    for (auto &location: locations) location = LOGGER_SOURCE_LOCATION_();
+    CHECK(locations[0] == locations[1]);
+    CHECK(std::string_view(locations[0]->text, locations[0]->text_size) == std::string(source_basename(__FILE__)) + ":" + std::to_string(locations[0]->line));
+
+    auto sink = std::make_shared<MemorySink>();
+    Logger::add_sink(sink);
+    Logger::enable_source();
+    int line = __LINE__; *(Logger::getInstance()->set_log_level(enumLogLevel::DEBUG_, __FILE__, line)) << "Runtime call site";
+    LogDebug << "Macro call site";
+    Logger::disable_source();
+    Logger::remove_sink(sink);
+
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(split_fields(lines[0])[2] == std::string(source_basename(__FILE__)) + ":" + std::to_string(line));
+    CHECK(split_fields(lines[1])[2] == std::string(source_basename(__FILE__)) + ":" + std::to_string(line + 1));
+}
+
+TEST_CASE("Structured fields are written as key-value pairs and JSON members", "[logger][json]"){
+    structLogFormat json_fmt;
+    json_fmt.fmt_timestamp = "";
+    json_fmt.fmt_output = enumOutputFormat::JSON;
+    auto json_sink = std::make_shared<MemorySink>();
+    json_sink->set_format(json_fmt);
+
+    structLogFormat text_fmt;
+    text_fmt.fmt_timestamp = "";
+    text_fmt.fmt_delimiter_type = enumDelimiterType::COMMA;
+    text_fmt.fmt_padding_size = enumPaddingSize::ZERO;
+    auto text_sink = std::make_shared<MemorySink>();
+    text_sink->set_format(text_fmt);
+
+    Logger::add_sink(json_sink);
+    Logger::add_sink(text_sink);
+    LogInfo.kv("user", "a\"b\\c").kv("ms", 42).kv("ratio", 0.5).kv("ok", true) << "Request\tdone\n";
+    LogWarning << "No fields " << std::string(1, '\x01');
+    Logger::remove_sink(json_sink);
+    Logger::remove_sink(text_sink);
+
+    auto json_lines = json_sink->get_lines();
+    REQUIRE(json_lines.size() == 2);
+    CHECK(json_lines[0] == "{\"level\":\"INFO\",\"message\":\"Request\\tdone\\n\",\"user\":\"a\\\"b\\\\c\",\"ms\":42,\"ratio\":0.5,\"ok\":true}\n");
+    CHECK(json_lines[1] == "{\"level\":\"WARNING\",\"message\":\"No fields \\u0001\"}\n");
+
+    auto text_lines = text_sink->get_lines();
+    REQUIRE(text_lines.size() == 2);
+    CHECK(text_lines[0] == "INFO,Request\tdone\n,user=a\"b\\c,ms=42,ratio=0.5,ok=true\n");
+
+    // Special characters at every offset of the vectorized blocks and the scalar tail
+    for (std::size_t size: {1, 15, 16, 17, 31, 33, 64}){
+        for (std::size_t pos=0; pos<size; pos++){
+            for (char special: {'"', '\\', '\x1F', '\x7F', '\xC3'}){
+                std::string input(size, 'x');
+                input[pos] = special;
+                std::string expected = "\"" + input.substr(0, pos);
+                if (special == '"') expected += "\\\"";
+                else if (special == '\\') expected += "\\\\";
+                else if (special == '\x1F') expected += "\\u001f";
+                else expected += special;
+                expected += input.substr(pos + 1) + "\"";
+
+                std::string out;
+                append_json_string(out, input);
+                CHECK(out == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Asynchronous messages of all threads are merged in order", "[logger][async]"){
+    structLogFormat fmt;
+    fmt.fmt_timestamp = EPOCH_NS_TIMESTAMP_FORMAT;
+    fmt.fmt_delimiter_type = enumDelimiterType::COMMA;
+    fmt.fmt_padding_size = enumPaddingSize::ZERO;
+    auto sink = std::make_shared<MemorySink>();
+    sink->set_format(fmt);
+    Logger::add_sink(sink);
+
+    const int thread_count = 4;
+    const int message_count = 500;
+    Logger::enable_async(256, enumOverflowPolicy::BLOCK);
+    // Producer threads exit before their buffers are drained
+    for (int round=0; round<2; round++){
+        std::vector<std::thread> threads;
+        for (int t=0; t<thread_count; t++){
+            threads.emplace_back([t, round](){
+                for (int i=0; i<message_count / 2; i++) LogTraceF("{} {}", t, round * (message_count / 2) + i);
+            });
+        }
+        for (auto &thread: threads) thread.join();
+    }
+    Logger::disable_async();
+    Logger::remove_sink(sink);
+
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == (std::size_t) (thread_count * message_count));
+
+    // Messages of a thread keep their order
+    std::vector<int> next(thread_count, 0);
+    for (const auto &line: lines){
+        std::size_t msg_pos = line.find(',', line.find(',') + 1) + 1;
+        int t = 0, i = 0;
+        std::istringstream(line.substr(msg_pos)) >> t >> i;
+        REQUIRE(t >= 0);
+        REQUIRE(t < thread_count);
+        CHECK(i == next[t]);
+        next[t] = i + 1;
+    }
+}
+
+TEST_CASE("Rate limited and sampled call sites report suppressed messages", "[logger][limit]"){
+    auto sink = std::make_shared<MemorySink>();
+    Logger::add_sink(sink);
+
+    int evaluated = 0;
+    for (int i=0; i<25; i++) LogInfoEvery(10) << "Every " << i << (evaluated++, "");
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == 3);
+    CHECK(evaluated == 3);
+    CHECK(split_fields(lines[0]).back() == "Every 0\n");
+    CHECK(split_fields(lines[1]).back() == "Every 10 [9 similar messages suppressed]\n");
+    CHECK(split_fields(lines[2]).back() == "Every 20 [9 similar messages suppressed]\n");
+
+    sink->clear();
+    for (int i=0; i<1000; i++) LogWarningRateLimited(5) << "Limited " << i;
+    CHECK(sink->get_lines().size() == 5);
+
+    sink->clear();
+    for (int i=0; i<1000; i++) LogDebugSampled(0.0) << "Never";
+    for (int i=0; i<100; i++) LogDebugSampled(1.0) << "Always";
+    CHECK(sink->get_lines().size() == 100);
+
+    sink->clear();
+    for (int i=0; i<10000; i++) LogDebugSampled(0.5) << "Half";
+    CHECK(sink->get_lines().size() > 4000);
+    CHECK(sink->get_lines().size() < 6000);
+
+    Logger::remove_sink(sink);
+}
+
+TEST_CASE("Repeated messages of a call site are folded into a summary", "[logger][duplicate]"){
+    auto sink = std::make_shared<MemorySink>();
+    Logger::add_sink(sink);
+    Logger::set_duplicate_suppression(true, 0);
+
+    for (int round=0; round<2; round++){
+        for (int i=0; i<5; i++) LogError << "Connection refused " << round;
+    }
+    for (int i=0; i<3; i++) LogError << "Connection reset";
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == 4);
+    CHECK(split_fields(lines[0]).back() == "Connection refused 0\n");
+    CHECK(split_fields(lines[1]).back() == "Last message repeated 4 times\n");
+    CHECK(split_fields(lines[2]).back() == "Connection refused 1\n");
+    CHECK(split_fields(lines[3]).back() == "Connection reset\n");
+
+    // Pending repeats of both call sites are reported when suppression is disabled
+    sink->clear();
+    Logger::set_duplicate_suppression(false);
+    std::vector<std::string> summaries;
+    for (const auto &line: sink->get_lines()) summaries.push_back(split_fields(line).back());
+    std::sort(summaries.begin(), summaries.end());
+    REQUIRE(summaries.size() == 2);
+    CHECK(summaries[0] == "Last message repeated 2 times\n");
+    CHECK(summaries[1] == "Last message repeated 4 times\n");
+
+    // Summary of a burst that stops is written by the housekeeping thread without a flush
+    sink->clear();
+    Logger::set_duplicate_suppression(true, 50);
+    for (int i=0; i<3; i++) LogError << "Disk full";
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (sink->get_lines().size() < 2 && std::chrono::steady_clock::now() < deadline){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    lines = sink->get_lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(split_fields(lines[1]).back() == "Last message repeated 2 times\n");
+    Logger::set_duplicate_suppression(false);
+
+    Logger::remove_sink(sink);
+}
+
+#if defined(__linux__)
+// Runs the hidden test cases of the tag in a new process of the test binary and returns its wait status.
+// The new process does not inherit threads or logger state of this one.
+static int run_in_child(const char *tag){
+    pid_t pid = fork();
+    if (pid == 0){
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        execl("/proc/self/exe", "LoggerTest", tag, (char*) nullptr);
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return status;
+}
+
+static std::vector<std::string> read_all_lines(const std::string &path){
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) lines.push_back(line);
+    return lines;
+}
+
+static void open_child_sink(const std::string &filename){
+    Logger::get_console_sink()->set_level(enumLogLevel::FATAL_);
+    auto sink = std::make_shared<FileSink>();
+    sink->set_flush_policy(enumFlushPolicy::EVERY_N_BYTES, 1 << 20);
+    sink->open(filename, ".");
+    Logger::add_sink(sink);
+}
+
+TEST_CASE("Child process crashing with pending records", "[.][crash_child]"){
+    open_child_sink("log_crash_test.txt");
+    // Handler of the test framework would report the abort as a failure
+    std::signal(SIGABRT, SIG_DFL);
+    Logger::set_crash_handler(true);
+    Logger::enable_async();
+    for (int i=0; i<100; i++) LogInfo << "Before crash " << i;
+    std::abort();
+}
+
+TEST_CASE("Child process shutting down with pending records", "[.][shutdown_child]"){
+    open_child_sink("log_shutdown_test.txt");
+    Logger::enable_async();
+    LogFatal << "Fatal message";
+    REQUIRE(read_all_lines("log_shutdown_test.txt").size() == 1);
+    for (int i=0; i<100; i++) LogInfo << "Before shutdown " << i;
+    REQUIRE(Logger::shutdown(1000));
+}
+
+TEST_CASE("Pending records are written on crash and at shutdown", "[logger][crash]"){
+    // Buffered and queued records reach the file before the process is killed by the signal
+    std::remove("log_crash_test.txt");
+    int status = run_in_child("[crash_child]");
+    CHECK(WIFSIGNALED(status));
+    CHECK(WTERMSIG(status) == SIGABRT);
+    auto lines = read_all_lines("log_crash_test.txt");
+    REQUIRE(lines.size() == 100);
+    CHECK(split_fields(lines[99]).back() == "Before crash 99");
+
+    // FATAL messages are drained at once, and the rest is drained by shutdown
+    std::remove("log_shutdown_test.txt");
+    status = run_in_child("[shutdown_child]");
+    REQUIRE(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+    CHECK(read_all_lines("log_shutdown_test.txt").size() == 101);
+
+    std::remove("log_crash_test.txt");
+    std::remove("log_shutdown_test.txt");
+}
+
+static std::string read_available(int fd){
+    std::string out;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(fd, buffer, sizeof(buffer))) > 0) out.append(buffer, (std::size_t) size);
+    return out;
+}
+
+TEST_CASE("Console output to a pipe is block-buffered and errors can go to stderr", "[logger][console]"){
+    int out_pipe[2], err_pipe[2];
+    REQUIRE(pipe2(out_pipe, O_NONBLOCK) == 0);
+    REQUIRE(pipe2(err_pipe, O_NONBLOCK) == 0);
+
+    auto sink = std::make_shared<ConsoleSink>(out_pipe[1], err_pipe[1]);
+    CHECK_FALSE(sink->is_tty());
+    CHECK(sink->is_block_buffered());
+    // Escape codes are written only to terminals
+    sink->set_colors(true);
+    sink->set_stderr_routing(true);
+    Logger::add_sink(sink);
+
+    LogInfo << "Pending line 1";
+    LogInfo << "Pending line 2";
+    CHECK(read_available(out_pipe[0]).empty());
+
+    // Pending lines are written before the error, which is written to stderr at once
+    LogError << "Routed error";
+    std::string out = read_available(out_pipe[0]);
+    std::string err = read_available(err_pipe[0]);
+    CHECK(out.find("Pending line 1\n") != std::string::npos);
+    CHECK(out.find("Pending line 2\n") != std::string::npos);
+    CHECK(out.find("Routed error") == std::string::npos);
+    CHECK(err.find("Routed error\n") != std::string::npos);
+    CHECK((out + err).find('\x1B') == std::string::npos);
+
+    // Idle output is written by the housekeeping thread within the flush interval
+    LogInfo << "Idle line";
+    std::string idle;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (idle.empty() && std::chrono::steady_clock::now() < deadline){
+        std::this_thread::sleep_for(std::chrono::milliseconds(DEFAULT_CONSOLE_FLUSH_INTERVAL_MS / 2));
+        idle = read_available(out_pipe[0]);
+    }
+    CHECK(idle.find("Idle line\n") != std::string::npos);
+
+    Logger::remove_sink(sink);
+    sink->flush();
+    for (int fd: {out_pipe[0], out_pipe[1], err_pipe[0], err_pipe[1]}) close(fd);
+}
+#endif
+
+TEST_CASE("Runtime metrics are aggregated from all threads", "[logger][stats]"){
+    structLoggerStats before = Logger::stats();
+
+    std::vector<std::thread> threads;
+    for (int t=0; t<4; t++){
+        threads.emplace_back([](){
+            for (int i=0; i<50; i++) LogWarning << "Counted " << i;
+            for (int i=0; i<10; i++) LogWarningEvery(5) << "Limited " << i;
+        });
+    }
+    for (auto &thread: threads) thread.join();
+    Logger::flush();
+
+    // Counters of exited threads are kept
+    structLoggerStats after = Logger::stats();
+    CHECK(after.level_counts[(int) enumLogLevel::WARNING_] - before.level_counts[(int) enumLogLevel::WARNING_] == 4 * 50 + 40 / 5);
+    CHECK(after.suppressed_count - before.suppressed_count == 40 - 40 / 5);
+    CHECK(after.console_bytes > before.console_bytes);
+    CHECK(after.format_time_ns > before.format_time_ns);
+
+    uint64_t histogram_total = 0;
+    for (auto count: after.flush_latency_histogram) histogram_total += count;
+    CHECK(histogram_total == after.flush_count);
+    CHECK(after.flush_count > before.flush_count);
+
+    // Messages dropped by the full asynchronous buffer are not counted as logged
+    Logger::enable_async(2, enumOverflowPolicy::DROP);
+    for (int i=0; i<1000; i++) LogAlert << "Maybe dropped " << i;
+    Logger::disable_async();
+    structLoggerStats dropped = Logger::stats();
+    CHECK(dropped.level_counts[(int) enumLogLevel::ALERT_] - after.level_counts[(int) enumLogLevel::ALERT_] +
+          dropped.dropped_count - after.dropped_count == 1000);
+}
+
+TEST_CASE("Configuration file is applied and reloaded when it changes", "[logger][config]"){
+    const std::string path = "log_test_config.yaml";
+    auto write_config = [&path](const std::string &text){
+        std::ofstream file(path, std::ios::trunc);
+        file << text;
+    };
+    write_config("# Test configuration\n"
+                 "level: info\n"
+                 "format:\n"
+                 "  timestamp: \"\"   # No timestamp\n"
+                 "  delimiter: comma\n"
+                 "batch:\n"
+                 "  max_records: 1\n");
+
+    auto sink = std::make_shared<MemorySink>();
+    Logger::add_sink(sink);
+    Logger::configure(path);
+    LogDebug << "Discarded";
+    LogInfo << "Configured";
+
+    const structLogConfig *config = Logger::get_config();
+    REQUIRE(config != nullptr);
+    CHECK(config->format.fmt_delimiter_type == enumDelimiterType::COMMA);
+    CHECK(Logger::get_log_threshold() == enumLogLevel::INFO_);
+
+    // Changed file is reloaded by the watcher. Settings whose keys are missing from the file are kept.
+    Logger::enable_source();
+    write_config("level: debug\nformat:\n  timestamp: ''\n  delimiter: space\n");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (Logger::get_log_threshold() != enumLogLevel::DEBUG_ && std::chrono::steady_clock::now() < deadline){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(Logger::get_log_threshold() == enumLogLevel::DEBUG_);
+    CHECK(Logger::get_settings()->is_source_enabled);
+    CHECK(LogSink::get_batch_max_records() == 1);
+    Logger::disable_source();
+    LogDebug << "Reloaded";
+
+    // Invalid file is reported, and the settings in use are kept
+    const structLogConfig *applied = Logger::get_config();
+    std::string error;
+    structLogConfig invalid;
+    CHECK_FALSE(parse_config("level: verbose\n", invalid, error));
+    CHECK_FALSE(parse_config("format\n", invalid, error));
+    CHECK(error == "Line 1 is not a \"key: value\" pair.");
+    CHECK(Logger::get_config() == applied);
+
+    Logger::remove_sink(sink);
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0] == "INFO,Configured\n");
+    CHECK(lines[1] == "DEBUG Reloaded\n");
+
+    Logger::set_log_threshold(enumLogLevel::TRACE_);
+    Logger::set_batch_policy(DEFAULT_BATCH_MAX_RECORDS, DEFAULT_BATCH_MAX_LATENCY_US);
+    structLogFormat fmt;
+    fmt.fmt_timestamp = DEFAULT_TIMESTAMP_FORMAT;
+    fmt.fmt_delimiter_type = DEFAULT_DELIMITER_TYPE;
+    fmt.fmt_padding_size = DEFAULT_PADDING_SIZE;
+    Logger::set_format(fmt);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Warm log calls do not allocate memory", "[logger][alloc]"){
+    open_test_log();
+    Logger::enable_source();
+    Logger::set_max_message_size(1024);
+    const std::string long_text(600, 'x');
+    const std::string huge_text(4096, 'y');
+    auto log_messages = [&](int count){
+        for (int i=0; i<count; i++){
+            LogWarning << "Short " << i;
+            LogWarning << "Long " << long_text << ' ' << 3.25 << ' ' << i;
+            LogDebug << "Huge " << huge_text;
+            LogWarning.kv("user", "alice").kv("id", i).kv("ok", true) << "Fields";
+            LogWarningF("Formatted {} of {}", i, count);
+            LogWarningEvery(10) << "Limited " << i;
+        }
+    };
+
+    auto count_allocations = [&](){
+        log_messages(64);
+        allocation_count = 0;
+        is_allocation_counted = true;
+        log_messages(256);
+        is_allocation_counted = false;
+        return allocation_count;
+    };
+    CHECK(count_allocations() == 0);
+
+    // Each slot of the queue grows to the longest message once
+    Logger::enable_async(64);
+    log_messages(1024);
+    CHECK(count_allocations() == 0);
+    Logger::disable_async();
+
+    Logger::set_max_message_size(0);
+    Logger::disable_source();
 }
@@ -0,0 +1,34 @@
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+
+#include <logger.h>
+
+using namespace logger;
+
+// This file is compiled with -DLOGGER_ACTIVE_LEVEL=LOGGER_LEVEL_INFO
+static_assert(LOGGER_ACTIVE_LEVEL == LOGGER_LEVEL_INFO, "Compile-time level of the file is not set.");
+
+TEST_CASE("Log calls above the compile-time level do not evaluate their operands", "[logger][threshold]"){
+    auto sink = std::make_shared<MemorySink>();
+    structLogFormat fmt;
+    fmt.fmt_timestamp = "";
+    fmt.fmt_delimiter_type = enumDelimiterType::COMMA;
+    fmt.fmt_padding_size = enumPaddingSize::ZERO;
+    sink->set_format(fmt);
+    Logger::add_sink(sink);
+    Logger::set_log_threshold(enumLogLevel::TRACE_);
+
+    int calls = 0;
+    auto f = [&calls](){ return ++calls; };
+    LogTrace << "Removed " << f();
+    LogDebugF("Removed {}", f());
+    LogInfo << "Kept " << f();
+    Logger::remove_sink(sink);
+
+    CHECK(calls == 1);
+    auto lines = sink->get_lines();
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0] == "INFO,Kept 1\n");
+}